@@ -4,13 +4,14 @@
 #include "hui/widget.hpp"
 #include "Utilities/ROACommon.hpp"
 #include "ROAUI.hpp"
+#include "BasicWidgets/RetainedLayer.hpp"
 #include "Utilities/ROAGUIRender.hpp"
 #include "Utilities/SVGImageConverter.hpp"
 
 namespace roa
 {
 
-class Button : public hui::Widget {
+class Button : public hui::Widget, public RetainedLayer {
 public:
     enum class Mode{
         HOVER_MODE,
@@ -50,6 +51,14 @@ public:
 
     bool IsPressed() const { return pressed; }
 
+    void SetPressed(bool newPressed) {
+        if (pressed == newPressed) return;
+        pressed = newPressed;
+        RequestRedraw(*this);
+        if (pressed && onPressAction) onPressAction();
+        if (!pressed && onUnpressAction) onUnpressAction();
+    }
+
     void SetMode(const Mode m) { mode = m; }
 
 protected:
@@ -66,13 +75,13 @@ protected:
             case Mode::HOVER_MODE: break;
             case Mode::FOCUS_MODE: break;
             case Mode::CAPTURE_MODE:
-                ForceRedraw(); 
+                RequestRedraw(*this); 
                 pressed = true; 
                 if (onPressAction) onPressAction();
                 break;
             case Mode::STICK_MODE: 
                 pressed = !pressed; 
-                ForceRedraw();
+                RequestRedraw(*this);
                 if (pressed && onPressAction) onPressAction();
                 if (!pressed && onUnpressAction) onUnpressAction();
                 break;
@@ -92,7 +101,7 @@ protected:
             case Mode::HOVER_MODE: break;
             case Mode::FOCUS_MODE: break;
             case Mode::CAPTURE_MODE: 
-                ForceRedraw();
+                RequestRedraw(*this);
                 pressed = false; 
                 if (onUnpressAction) onUnpressAction();
                 break;
@@ -114,7 +123,7 @@ protected:
                     if (pressed != newPressed) {
                         if (newPressed && onPressAction) onPressAction();
                         if (!newPressed && onUnpressAction) onUnpressAction();
-                        ForceRedraw();
+                        RequestRedraw(*this);
                     } 
                     pressed = newPressed;
                     break;
@@ -125,7 +134,7 @@ protected:
                     if (pressed != newPressed) {
                         if (newPressed && onPressAction) onPressAction();
                         if (!newPressed && onUnpressAction) onUnpressAction();
-                        ForceRedraw();
+                        RequestRedraw(*this);
                     } 
                     pressed = newPressed;
                     break;
@@ -154,14 +163,14 @@ protected:
 private:
     void addStateProperty(const StateProperty property) {
         uint8_t newState = state | static_cast<uint8_t>(property);
-        if (!(newState == state)) ForceRedraw();
+        if (!(newState == state)) RequestRedraw(*this);
         state = newState;
     }
 
     void removeStateProperty(const StateProperty property) {
         uint8_t newState = state & ~static_cast<uint8_t>(property);
             
-        if (!(newState == state)) ForceRedraw();
+        if (!(newState == state)) RequestRedraw(*this);
         state = newState;
     }
 };
@@ -179,26 +188,24 @@ public:
 
     void SetNonActiveColor(const dr4::Color color) {
         nonActiveColor = color;
-        ForceRedraw();
+        RequestRedraw(*this);
     }
     
     void SetHoverColor(const dr4::Color color) {
         hoverColor = color;
-        ForceRedraw();
+        RequestRedraw(*this);
     }
 
     void SetClickedColor(const dr4::Color color) {
         clickedColor = color;
-        ForceRedraw();
+        RequestRedraw(*this);
     }
 
 protected:
     void Redraw() const override final {
+        if (!beginLayerRedraw(*this)) return;
         GetTexture().Clear(FULL_TRANSPARENT);
 
-        dr4::Image *backSurface = GetTexture().GetImage();
-        assert(backSurface);
-
         dr4::Color bgColor = nonActiveColor;
         if (checkStateProperty(Button::StateProperty::CLICKED)) {
             bgColor = clickedColor;
@@ -206,17 +213,7 @@ protected:
             bgColor = hoverColor;
         }
 
-        DrawBlenderRoundedRectangle(
-            backSurface->GetWidth(),
-            backSurface->GetHeight(),
-            borderRadius,               
-            0,                
-            FULL_TRANSPARENT,  
-            bgColor,
-            [&](int x, int y, dr4::Color c) { backSurface->SetPixel(x,y,c); }
-        );
-
-        backSurface->DrawOn(GetTexture());
+        static_cast<UI*>(GetUI())->GetSkin({.radius = borderRadius, .fill = bgColor}).DrawOn(GetTexture(), GetSize());
     }
 };
 
@@ -245,34 +242,34 @@ public:
 
     void SetNonActiveColor(const dr4::Color color) {
         nonActiveColor = color;
-        ForceRedraw();
+        RequestRedraw(*this);
     }
     
     void SetHoverColor(const dr4::Color color) {
         hoverColor = color;
-        ForceRedraw();
+        RequestRedraw(*this);
     }
 
     void SetClickedColor(const dr4::Color color) {
         clickedColor = color;
-        ForceRedraw();
+        RequestRedraw(*this);
     }
 
     void SetBorderThickness(const int thikness) {
         borderThikness = thikness;
-        ForceRedraw();
+        RequestRedraw(*this);
     }
 
     void SetLabelFontSize(const int fontSize) {
         label->SetFontSize(fontSize);
         relayoutLabel();
-        ForceRedraw();
+        RequestRedraw(*this);
     }
 
     void SetLabel(const std::string &content) {
         label->SetText(content);
         relayoutLabel();
-        ForceRedraw();
+        RequestRedraw(*this);
     }
 
 protected:
@@ -284,16 +281,14 @@ protected:
         if (label->GetBounds().x > GetSize().x) return;
         if (label->GetBounds().y > GetSize().y) return;
         label->SetPos((GetSize().x - label->GetBounds().x) / 2, (GetSize().y - label->GetBounds().y) / 2);
-        ForceRedraw();
+        RequestRedraw(*this);
     }
 
     void Redraw() const override final {
+        if (!beginLayerRedraw(*this)) return;
         GetTexture().Clear(FULL_TRANSPARENT);
        
     
-        dr4::Image *backSurface = GetTexture().GetImage();
-        assert(backSurface);
-
         dr4::Color bgColor = nonActiveColor;
         if (checkStateProperty(Button::StateProperty::CLICKED)) {
             bgColor = clickedColor;
@@ -301,17 +296,7 @@ protected:
             bgColor = hoverColor;
         }
 
-        DrawBlenderRoundedRectangle(
-            backSurface->GetWidth(),
-            backSurface->GetHeight(),
-            borderRadius,               
-            0,                
-            FULL_TRANSPARENT,  
-            bgColor,
-            [&](int x, int y, dr4::Color c) { backSurface->SetPixel(x,y,c); }
-        );
-
-        backSurface->DrawOn(GetTexture());
+        static_cast<UI*>(GetUI())->GetSkin({.radius = borderRadius, .fill = bgColor}).DrawOn(GetTexture(), GetSize());
         label->DrawOn(GetTexture());
     }
 };
@@ -3,12 +3,21 @@
 
 #include "hui/container.hpp"
 #include "BasicWidgets/Buttons.hpp"
+#include "BasicWidgets/RetainedLayer.hpp"
 #include "Utilities/ROACommon.hpp"
 
 namespace roa
 {
 
-class Container : public hui::Container {
+class Container : public hui::Container, public RetainedLayer {
+    // children as last composited, see syncLayerContent
+    struct ComposedChild {
+        const hui::Widget *widget;
+        dr4::Rect2f        rect;
+        bool               tracked; // a RetainedLayer, so its redraws dirty this layer
+    };
+    mutable std::vector<ComposedChild> composed;
+
 protected:
     std::vector<std::unique_ptr<hui::Widget>> children; 
     std::vector<std::unique_ptr<hui::Widget>> erasable;
@@ -23,7 +32,7 @@ public:
     void AddWidget(std::unique_ptr<hui::Widget> widget) {
         hui::Container::BecomeParentOf(widget.get());
         children.push_back(std::move(widget));
-        ForceRedraw();
+        RequestRedraw(*this);
     }
 
     bool CheckImplicitHover() const {
@@ -41,15 +50,28 @@ public:
         if (it != children.end()) {
             erasable.push_back(std::move(*it));
             children.erase(it);
+            RequestRedraw(*this);
         }
     }
 
+    // Removes `widget` like EraseWidget, but hands it back instead of destroying it.
+    std::unique_ptr<hui::Widget> ReleaseWidget(hui::Widget *widget) {
+        auto it = std::find_if(children.begin(), children.end(), [widget](const auto &ptr){ return ptr.get() == widget; });
+        if (it == children.end()) return nullptr;
+
+        std::unique_ptr<hui::Widget> released = std::move(*it);
+        children.erase(it);
+        RequestRedraw(*this);
+        return released;
+    }
+
     void BringToFront(hui::Widget *widget) {
         auto it = std::find_if(children.begin(), children.end(), [widget](const auto &ptr){ return ptr.get() == widget; });
         if (it != children.end()) {
             auto uptr = std::move(*it);
             children.erase(it);
             children.insert(children.begin(), std::move(uptr));
+            RequestRedraw(*this);
         }
     }
 
@@ -61,6 +83,43 @@ protected:
         return hui::EventResult::UNHANDLED;
     }
 
+    // Children moved by hui or by code that only redrew the child still need recompositing,
+    // and widgets that are not retained layers (plugin widgets) may redraw without telling us.
+    // Both are reported as damage too, where they were and where they are now.
+    bool syncLayerContent() const override {
+        UI *ui = static_cast<UI *>(GetUI());
+        dr4::Vec2f origin = GetScreenRect(*this).pos;
+        auto damage = [ui, origin](dr4::Rect2f rect) {
+            rect.pos += origin;
+            ui->AddDamage(rect);
+        };
+
+        bool changed = (composed.size() != children.size());
+        composed.resize(children.size(), {nullptr, {}, false});
+        for (size_t i = 0; i < children.size(); i++) {
+            const hui::Widget *child = children[i].get();
+            ComposedChild &entry = composed[i];
+            if (entry.widget != child) {
+                entry = {child, child->GetRect(), dynamic_cast<const RetainedLayer *>(child) != nullptr};
+                damage(entry.rect);
+                changed = true;
+            }
+            dr4::Rect2f rect = child->GetRect();
+            if (rect.pos.x != entry.rect.pos.x || rect.pos.y != entry.rect.pos.y ||
+                rect.size.x != entry.rect.size.x || rect.size.y != entry.rect.size.y) {
+                damage(entry.rect);
+                damage(rect);
+                entry.rect = rect;
+                changed = true;
+            }
+            if (!entry.tracked) {
+                damage(rect);
+                changed = true;
+            }
+        }
+        return changed;
+    }
+
     hui::EventResult OnIdle(hui::IdleEvent &evt) {
         PropagateToChildren(evt);
         erasable.clear();
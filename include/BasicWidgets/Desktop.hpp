@@ -1,4 +1,6 @@
 #pragma once
+#include <optional>
+
 #include "BasicWidgets/Containers.hpp"
 #include "CompositeWidgets/DropDownMenu.hpp"
 
@@ -7,6 +9,7 @@ namespace roa
 
 class Desktop : public Container {
     std::unique_ptr<dr4::Rectangle> mainMenuBackGround;
+    std::unique_ptr<dr4::Rectangle> damageBackGround;
     std::vector<DropDownMenu *> mainMenu;
     
     std::unique_ptr<hui::Widget> modal;
@@ -17,12 +20,18 @@ public:
     const dr4::Color mainMenuColor = dr4::Color(24, 24, 24, 255);
     const dr4::Color BGColor = dr4::Color(61, 61, 61, 255);
     
-    Desktop(hui::UI *ui) : Container(ui), mainMenuBackGround(ui->GetWindow()->CreateRectangle()) {
+    Desktop(hui::UI *ui) : 
+        Container(ui), 
+        mainMenuBackGround(ui->GetWindow()->CreateRectangle()),
+        damageBackGround(ui->GetWindow()->CreateRectangle()) 
+    {
         assert(ui);
     
         SetSize(ui->GetWindow()->GetSize());
         mainMenuBackGround->SetSize({GetSize().x, MAIN_MENU_HEIGHT});
         mainMenuBackGround->SetFillColor(mainMenuColor);
+        damageBackGround->SetFillColor(BGColor);
+        static_cast<UI*>(ui)->SetRootReportsRedraws(true);
     }
 
     Desktop(const Container&) = delete;
@@ -52,15 +61,15 @@ public:
     }
     void ActivateModal() { 
         modalActivated = true;
-        ForceRedraw(); 
+        RequestRedraw(*this); 
     }
     void DeactivateModal() {
         modalActivated = false; 
-        ForceRedraw(); 
+        RequestRedraw(*this); 
     }
     void SwitchModalActiveFlag() {
         modalActivated = !modalActivated;
-        ForceRedraw(); 
+        RequestRedraw(*this); 
     }
 
 
@@ -79,19 +88,49 @@ protected:
         return hui::EventResult::UNHANDLED;
     }
 
+    // Only the damaged region is recomposited, from the children it touches.
     void Redraw() const override {
-        GetTexture().Clear(BGColor);
+        if (!beginLayerRedraw(*this)) return;
+        UI *ui = static_cast<UI*>(GetUI());
+        ui->NoteRootRedrawn();
+
+        std::optional<dr4::Rect2f> damage = ui->GetDamage();
+        bool partial = (damage && !ui->IsFullDamage());
+        composite(partial ? damage : std::nullopt);
+
+        // Nested containers report children that moved while they redraw, after the clip was
+        // set. Those children are clean by now, so the grown region is only blitted again.
+        std::optional<dr4::Rect2f> grown = ui->GetDamage();
+        if (partial && grown && (grown->pos.x != damage->pos.x || grown->pos.y != damage->pos.y ||
+                                 grown->size.x != damage->size.x || grown->size.y != damage->size.y)) {
+            composite(grown);
+        }
+    }
+
+private:
+    // `damage` in window coordinates, nullopt redraws everything
+    void composite(std::optional<dr4::Rect2f> damage) const {
+        if (damage) {
+            damage->pos -= GetPos();
+            GetTexture().SetClipRect(*damage);
+            damageBackGround->SetPos(damage->pos);
+            damageBackGround->SetSize(damage->size);
+            damageBackGround->DrawOn(GetTexture());
+        } else {
+            GetTexture().Clear(BGColor);
+        }
         mainMenuBackGround->DrawOn(GetTexture());
 
         for (auto it = children.rbegin(); it != children.rend(); it++) {
+            if (damage && !rectsIntersect((*it)->GetRect(), *damage)) continue;
             (*it)->DrawOn(GetTexture());
         }
         if (modal && modalActivated) {
             modal->DrawOn(GetTexture());
         }
+        if (damage) GetTexture().RemoveClipRect();
     }
 
-private:
     float calculateMainMenuWidth() const { 
         float res = 0;
         for (auto item : mainMenu) {
@@ -0,0 +1,59 @@
+#pragma once
+
+#include "hui/widget.hpp"
+#include "ROAUI.hpp"
+
+namespace roa
+{
+
+// A widget texture kept between frames. RequestRedraw marks the layer and its retained
+// ancestors dirty; on any frame a clean layer skips its Redraw and its parent just
+// composites the texture it already has, so input only redraws the widgets it changed.
+// Layers that cannot see all their changes report them through syncLayerContent.
+class RetainedLayer {
+    mutable bool       layerDirty = true;
+    mutable dr4::Vec2f layerSize  = {-1, -1};
+
+public:
+    virtual ~RetainedLayer() = default;
+
+    bool IsLayerDirty() const { return layerDirty; }
+
+    // Dirties the layer of `widget`, if it has one, and of every retained ancestor.
+    // The whole chain is walked: an ancestor may be clean while a child it skipped is still dirty.
+    static void InvalidateLayers(const hui::Widget &widget) {
+        if (auto layer = dynamic_cast<const RetainedLayer *>(&widget)) layer->layerDirty = true;
+        for (hui::Widget *parent = widget.GetParent(); parent && parent != parent->GetParent(); parent = parent->GetParent()) {
+            if (auto layer = dynamic_cast<RetainedLayer *>(parent)) layer->layerDirty = true;
+        }
+    }
+
+protected:
+    // Called on every beginLayerRedraw: true if something the layer shows changed without
+    // a RequestRedraw reaching it since the previous call.
+    virtual bool syncLayerContent() const { return false; }
+
+    // First thing in Redraw: false means the texture still holds what has to be shown.
+    // A resized texture is redrawn even if nobody asked.
+    bool beginLayerRedraw(const hui::Widget &self) const {
+        dr4::Vec2f size = self.GetSize();
+        bool resized = (size.x != layerSize.x || size.y != layerSize.y);
+        bool contentChanged = syncLayerContent();
+        if (!layerDirty && !resized && !contentChanged) return false;
+
+        layerDirty = false;
+        layerSize = size;
+        return true;
+    }
+};
+
+// Redraws `widget`: reports its rect as damage (see UI::AddDamage), dirties the retained
+// layers from it up to the root and lets hui redraw it. Widgets in this tree redraw through
+// here instead of hui::Widget::ForceRedraw, which knows nothing about damage or layers.
+inline void RequestRedraw(hui::Widget &widget) {
+    static_cast<UI *>(widget.GetUI())->DamageWidget(widget);
+    RetainedLayer::InvalidateLayers(widget);
+    widget.ForceRedraw();
+}
+
+} // namespace roa
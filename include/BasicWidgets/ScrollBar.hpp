@@ -39,7 +39,7 @@ protected:
             accumulatedRel = {0, 0};
             replaced = false;
             if (onReplaceAction) onReplaceAction();
-            ForceRedraw();
+            RequestRedraw(*this);
         }
     }
     
@@ -107,12 +107,12 @@ public:
     bool IsHidden() const { return hiden; }
     void Hide() { 
         hiden = true; 
-        ForceRedraw();
+        RequestRedraw(*this);
     }
 
     void Show() { 
         hiden = false;
-        ForceRedraw();
+        RequestRedraw(*this);
     }
 
 protected:
@@ -120,6 +120,7 @@ protected:
 
 protected:
     void Redraw() const override {
+        if (!beginLayerRedraw(*this)) return;
         GetTexture().Clear(FULL_TRANSPARENT);
         if (!hiden) {
             thumbButton->DrawOn(GetTexture());
@@ -141,7 +142,7 @@ protected:
 
             if (calculateThumbMovingArea().Contains(event.pos)) {
                 thumbButton->SetPos(event.pos);
-                ForceRedraw();
+                RequestRedraw(*this);
             }
 
             event.pos += GetPos();
@@ -196,7 +197,7 @@ private:
         dr4::Rect2f thumbMovingArea = calculateThumbMovingArea();
 
         thumbButton->SetPos({0, static_cast<float>(thumbMovingArea.pos.y + thumbMovingArea.size.y * percentage)});
-        ForceRedraw();
+        RequestRedraw(*this);
     }
 
     void moveThumb(double deltaPercent) {
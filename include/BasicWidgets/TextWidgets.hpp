@@ -1,16 +1,18 @@
 #pragma once
 #include <functional>
 #include <cstring>
+#include <string_view>
 
 #include "hui/widget.hpp"
 
 #include "ROAUI.hpp"
+#include "BasicWidgets/RetainedLayer.hpp"
 #include "Utilities/ROACommon.hpp"
 
 namespace roa
 {
 
-class TextWidget : public hui::Widget {
+class TextWidget : public hui::Widget, public RetainedLayer {
 protected:
     std::unique_ptr<dr4::Text> text;
 
@@ -33,33 +35,38 @@ public:
         assert(font);
 
         text->SetFont(font);
-        ForceRedraw();
+        RequestRedraw(*this);
     }
 
     void SetFontSize(const int fontSize) {
         text->SetFontSize(fontSize);
-        ForceRedraw();
+        RequestRedraw(*this);
     }
 
     std::string GetText() const {
         return text->GetText();
     }
 
+    // compares without copying the text out
+    bool HasText(std::string_view content) const {
+        return std::string_view(text->GetText()) == content;
+    }
+
     void SetText(const std::string &content) {
         text->SetText(content);
         relayoutCaret();
-        ForceRedraw();
+        RequestRedraw(*this);
     }
 
     void SetColor(const dr4::Color color) {
         text->SetColor(color);
         caret->SetColor(color);
-        ForceRedraw();
+        RequestRedraw(*this);
     }
 
     void SetVAlign(const dr4::Text::VAlign align) {
         text->SetVAlign(align); 
-        ForceRedraw();
+        RequestRedraw(*this);
     }
 
     void SetBGColor(const dr4::Color color) { 
@@ -73,19 +80,22 @@ public:
 
     void ShowCaret() { 
         drawCaret = true; 
-        ForceRedraw();
+        RequestRedraw(*this);
     }
     void HideCaret() { 
+        if (!drawCaret) return; // unfocused fields hide it on every blink
         drawCaret = false; 
-        ForceRedraw();
+        RequestRedraw(*this);
     }  
     void BlinkCaret() {
         if (drawCaret) HideCaret();
         else ShowCaret();
     }
+    bool IsCaretShown() const { return drawCaret; }
 
 protected:
     void Redraw() const override {
+        if (!beginLayerRedraw(*this)) return;
         GetTexture().Clear(BGColor);
         text->DrawOn(GetTexture());
         if (drawCaret) {
@@ -169,6 +179,8 @@ protected:
             if (!caretBlinkState) HideCaret();
             else BlinkCaret();
         }
+        // the next blink, or hiding a caret left by lost focus, is the only thing to wake up for
+        if (caretBlinkState || IsCaretShown()) static_cast<UI*>(GetUI())->RequestFrameAfter(curCaretBlinkDeltaSecs);
 
         if (needOnEnterCall_) {
             if (onEnterAction) onEnterAction(text->GetText());
@@ -184,7 +196,7 @@ protected:
         textBufer.insert(caretPos, event.text);
         caretPos += static_cast<int>(textBufer.size()) -  prevSize;
         SetText(textBufer);
-        ForceRedraw();
+        RequestRedraw(*this);
         return hui::EventResult::HANDLED;
     }
 
@@ -194,25 +206,25 @@ protected:
                 textBufer.erase(caretPos - 1, 1);
                 caretPos--;
                 SetText(textBufer);
-                ForceRedraw();
+                RequestRedraw(*this);
             }
             return hui::EventResult::HANDLED;
         }
 
         if (event.key == dr4::KeyCode::KEYCODE_ENTER) {
             needOnEnterCall_ = true;
-            ForceRedraw();
+            RequestRedraw(*this);
             return hui::EventResult::HANDLED;
         }
 
         if (event.key == dr4::KeyCode::KEYCODE_LEFT) {
             caretPos = std::max(0, caretPos - 1);
-            ForceRedraw();
+            RequestRedraw(*this);
             return hui::EventResult::HANDLED;
         }
         if (event.key == dr4::KeyCode::KEYCODE_RIGHT) {
             caretPos = std::min(static_cast<int>(textBufer.size()), caretPos + 1);
-            ForceRedraw();
+            RequestRedraw(*this);
             return hui::EventResult::HANDLED;
         }
 
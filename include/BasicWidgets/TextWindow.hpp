@@ -1,6 +1,8 @@
 #pragma once
 
+#include <algorithm>
 #include <filesystem>
+#include <functional>
 #include <memory>
 #include <string>
 
@@ -25,9 +27,21 @@ class TextWindow final : public Window {
     bool requestBringToFront = true;
     std::string pendingTitle;
 
+    std::unique_ptr<dr4::Rectangle> progressTrack;
+    std::unique_ptr<dr4::Rectangle> progressFill;
+    float progress = -1; // negative hides the bar
+
+    std::function<void()> onCloseAction = nullptr;
+
 public:
-    TextWindow(hui::UI *ui): Window(ui) {
+    TextWindow(hui::UI *ui):
+        Window(ui),
+        progressTrack(ui->GetWindow()->CreateRectangle()),
+        progressFill(ui->GetWindow()->CreateRectangle())
+    {
         assert(ui);
+        progressTrack->SetFillColor({45, 45, 45, 255});
+        progressFill->SetFillColor({74, 114, 179, 255});
         InitLayout();
     }
 
@@ -41,26 +55,39 @@ public:
     void SetTitle(const std::string &t) {
         pendingTitle = t;
         if (titleWidget) titleWidget->SetText(t);
-        ForceRedraw();
+        RequestRedraw(*this);
     }
 
     void SetOkButtonLabel(const std::string &label) {
         assert(okButton);
         okButton->SetLabel(label);
-        ForceRedraw();
+        RequestRedraw(*this);
     }
     void SetCancelButtonLabel(const std::string &label) {
         assert(cancelButton);
         cancelButton->SetLabel(label);
-        ForceRedraw();
+        RequestRedraw(*this);
     }
 
     void DisplayMessage(const std::string &message, const dr4::Color color=WHITE) {
         messageField->SetText(message);
         messageField->SetColor(color);
-        ForceRedraw();
+        RequestRedraw(*this);
     }
     
+    // fraction in [0, 1], shown as a bar between the message and the buttons
+    void SetProgress(float fraction) {
+        progress = std::clamp(fraction, 0.0f, 1.0f);
+        RequestRedraw(*this);
+    }
+    void HideProgress() {
+        progress = -1;
+        RequestRedraw(*this);
+    }
+
+    // called when the window is closed by the close or cancel button
+    void SetOnCloseAction(std::function<void()> action) { onCloseAction = action; }
+
     void SetInputFieldOnEnterAction(std::function<void(const std::string &text)> action) {
         inputField->SetOnEnterAction(action);
         okButton->SetOnPressAction([this, action](){ action(inputField->GetText()); });
@@ -86,13 +113,7 @@ public:
         closeButton->SetClickedColor({109, 32, 41, 255});
         closeButton->SetSize({24, 18});
         closeButton->SetPos({GetSize().x - closeButton->GetSize().x - 6, 6});
-        closeButton->SetOnPressAction([this] {
-            if (auto parent = GetParent()) {
-                if (auto container = dynamic_cast<roa::Container*>(parent)) {
-                    container->EraseWidget(this);
-                }
-            }
-        });
+        closeButton->SetOnPressAction([this] { close(); });
         AddWidget(std::move(closeButtonUnique));
 
         auto in = std::make_unique<TextInputWidget>(GetUI());
@@ -135,18 +156,12 @@ public:
         cancelButton->SetLabelFontSize(static_cast<UI*>(GetUI())->GetTexturePack().fontSize);
         cancelButton->SetSize({(GetSize().x - 12 - PADDING) / 2, 24});
         cancelButton->SetPos(okButton->GetPos() + dr4::Vec2f(cancelButton->GetSize().x + PADDING, 0));
-        cancelButton->SetOnPressAction([this] {  
-            if (auto parent = GetParent()) {
-                if (auto container = dynamic_cast<roa::Container*>(parent)) {
-                    container->EraseWidget(this);
-                }
-            }
-        });
+        cancelButton->SetOnPressAction([this] { close(); });
 
         AddWidget(std::move(cancelButtonUnique));
 
         SetSize(GetSize());
-        ForceRedraw();
+        RequestRedraw(*this);
     }
 
 protected:
@@ -187,6 +202,27 @@ protected:
         GetTexture().Clear({61, 61, 61});
 
         // draw title background area (kept inside titleWidget which has its own BG)
+
+        if (progress >= 0) {
+            dr4::Vec2f pos = messageField->GetPos() + dr4::Vec2f(0, messageField->GetSize().y + 8);
+            progressTrack->SetPos(pos);
+            progressTrack->SetSize({messageField->GetSize().x, 8});
+            progressTrack->DrawOn(GetTexture());
+
+            progressFill->SetPos(pos);
+            progressFill->SetSize({messageField->GetSize().x * progress, 8});
+            progressFill->DrawOn(GetTexture());
+        }
+    }
+
+private:
+    void close() {
+        if (onCloseAction) onCloseAction();
+        if (auto parent = GetParent()) {
+            if (auto container = dynamic_cast<roa::Container*>(parent)) {
+                container->EraseWidget(this);
+            }
+        }
     }
 };
 
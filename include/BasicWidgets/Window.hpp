@@ -14,6 +14,7 @@ class Window : public Container  {
 
     std::unique_ptr<dr4::Rectangle> toolsBG;
     std::vector<DropDownMenu *> tools;
+    dr4::Color skinMatte = dr4::Color(61, 61, 61, 255); // what the window usually sits on, see SkinStyle
 public:
     float TOOL_BAR_HEIGHT = 20;
     static constexpr float TOOL_WIDTH = 60;
@@ -42,14 +43,19 @@ public:
 
     void SetToolsBG(const dr4::Color color) {
         toolsBG->SetFillColor(color);
-        ForceRedraw();
+        RequestRedraw(*this);
+    }
+
+    void SetSkinMatte(const dr4::Color color) {
+        skinMatte = color;
+        RequestRedraw(*this);
     }
 
 protected:
     hui::EventResult OnIdle(hui::IdleEvent &evt) override {
         PropagateToChildren(evt);
         bool newImplicitHovered = CheckImplicitHover();
-        if (newImplicitHovered != implicitHovered) ForceRedraw();
+        if (newImplicitHovered != implicitHovered) RequestRedraw(*this);
         implicitHovered = newImplicitHovered;
         
         return hui::EventResult::UNHANDLED;
@@ -58,6 +64,7 @@ protected:
     virtual void WindowDrawSelfAction() const {}
 
     void Redraw() const override {
+        if (!beginLayerRedraw(*this)) return;
         GetTexture().Clear(FULL_TRANSPARENT);
         toolsBG->SetSize({GetSize().x, TOOL_BAR_HEIGHT});
         toolsBG->DrawOn(GetTexture());
@@ -66,20 +73,14 @@ protected:
         for (auto &child : children) child->DrawOn(GetTexture());
         for (auto &tool : tools) tool->DrawOn(GetTexture());
         
-        dr4::Image *backSurface = GetTexture().GetImage();
         dr4::Color borderColor = (implicitHovered ? dr4::Color(88, 88, 88, 255) : dr4::Color(55,55,55,255));
-        
-        DrawBlenderRoundedFrame(
-            backSurface->GetWidth(),
-            backSurface->GetHeight(),
-            10,               // radius
-            2,                // border thickness
-            borderColor,      // blender border
-            [&](int x, int y, dr4::Color c) { backSurface->SetPixel(x,y,c); }
-        );
-
-        GetTexture().Clear(FULL_TRANSPARENT);
-        backSurface->DrawOn(GetTexture());
+        SkinStyle frame = {
+            .radius = 10,
+            .border = 2,
+            .borderColor = borderColor,
+            .matte = skinMatte
+        };
+        static_cast<UI*>(GetUI())->GetSkin(frame).DrawOn(GetTexture(), GetSize());
     }
 
 private:
@@ -55,46 +55,40 @@ public:
 
     void SetBorderThinkess(const int thikness) {
         borderThickness = thikness;
-        ForceRedraw();
+        RequestRedraw(*this);
     }
 
     void SetBorderColor(const dr4::Color color) {
         borderColor = color;
-        ForceRedraw();
+        RequestRedraw(*this);
     }
 
     void Hide() { 
         pressed = false;
         if (onUnpressAction) onUnpressAction();
-        ForceRedraw();
+        RequestRedraw(*this);
     }
 
     void SetLabel(const std::string &text) { label->SetText(text); }
     void SetLabelFontSize(int fontSize) { 
         label->SetFontSize(fontSize); 
-        ForceRedraw();
+        RequestRedraw(*this);
     }
 
     bool IsDropDownActive() const { return pressed; }
 
 protected:
     void Redraw() const override final {
+        if (!beginLayerRedraw(*this)) return;
         GetTexture().Clear(FULL_TRANSPARENT);
 
-        dr4::Image* backSurface = GetTexture().GetImage();
-        assert(backSurface);
-
-        DrawBlenderRoundedRectangle(
-            backSurface->GetWidth(),
-            backSurface->GetHeight(),
-            borderRadius,
-            borderThickness,
-            borderColor,
-            buttonColor,
-            [&](int x, int y, dr4::Color c) { backSurface->SetPixel(x, y, c); }
-        );
-
-        backSurface->DrawOn(GetTexture());
+        SkinStyle skin = {
+            .radius = borderRadius,
+            .border = borderThickness,
+            .borderColor = borderColor,
+            .fill = buttonColor
+        };
+        static_cast<UI*>(GetUI())->GetSkin(skin).DrawOn(GetTexture(), GetSize());
 
         if (pressed) dropDownActiveIcon->DrawOn(GetTexture());
         else dropDownNonActiveIcon->DrawOn(GetTexture());
@@ -146,16 +140,16 @@ public:
 
     void SetLabelFontSize(const int fontSize) {
         topButton->SetLabelFontSize(fontSize); 
-        ForceRedraw();
+        RequestRedraw(*this);
     }
     void SetLabel(const std::string& label) { 
         topButton->SetLabel(label); 
-        ForceRedraw();
+        RequestRedraw(*this);
     }
     void SetDropDownWidget(std::unique_ptr<hui::Widget> wgt) { 
         dropDown = wgt.get(); 
         AddWidget(std::move(wgt));
-        ForceRedraw(); 
+        RequestRedraw(*this); 
     }
 
     void SetOnSizeChangedAction(std::function<void()> action) { onSizeChangedAction = action; }
@@ -178,6 +172,7 @@ protected:
     }
 
     void Redraw() const override {
+        if (!beginLayerRedraw(*this)) return;
         GetTexture().Clear(FULL_TRANSPARENT);
         topButton->DrawOn(GetTexture());
 
@@ -202,7 +197,7 @@ private:
             SetSize(originSize);
         }
 
-        ForceRedraw();
+        RequestRedraw(*this);
         detailResize = false;
     }
 };
@@ -1,14 +1,35 @@
 #pragma once
 #include <cassert>
+#include <charconv>
+#include <chrono>
+#include <deque>
+#include <exception>
+#include <filesystem>
+#include <fstream>
 #include <functional>
 #include <optional>
+#include <span>
+#include <spanstream>
+#include <sstream>
 #include <string>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 #include <cstdlib>
 
 #include "BasicWidgets/Containers.hpp"
 #include "Utilities/ROAGUIRender.hpp"
+#include "RayTracerWidgets/MaterialTable.hpp"
 #include "RayTracerWidgets/Viewport3D.hpp"
+#include "Utilities/BinaryScene.hpp"
+#include "Utilities/EditJournal.hpp"
+#include "Utilities/MeshImport.hpp"
+#include "Utilities/MeshLoadTask.hpp"
+#include "Utilities/SceneConvertTask.hpp"
+#include "Utilities/SceneParser.hpp"
+#include "Utilities/SceneLoadTask.hpp"
+#include "Utilities/SceneSaveTask.hpp"
+#include "Utilities/SceneWriter.hpp"
 
 #include "CompositeWidgets/Outliner.hpp"
 #include "CompositeWidgets/RecordsPanel.hpp"
@@ -29,8 +50,85 @@ class EditorWidget final : public Container {
     Viewport3DWindow             *viewport3D      = nullptr;
     OutlinerWindow<Primitives *> *outliner        = nullptr;
     PropertiesWindow             *propertiesPanel = nullptr;
+
+    // keys of the pooled property groups in the properties panel
+    enum class PropertyGroup : size_t {
+        TRANSFORM, DIFFUSE, SPECULAR, EMITTED, SPHERE, PLANE, CUBE, VISIBILITY
+    };
+    ::Primitives        *propertiesObject = nullptr; // object the property groups are bound to
+    std::vector<size_t>  shownPropertyGroups;
     
     RTMaterialManager materialManager;
+    MaterialTable     materials{materialManager};
+
+    std::optional<AABB> selectedBounds = std::nullopt;
+    size_t              addedObjectCount = 0;
+
+    static constexpr double SCENE_LOAD_BUDGET_SECS = 0.008; // per frame, keeps the UI responsive
+    static constexpr size_t SCENE_LOAD_BATCH_SIZE  = 32;
+
+    std::unique_ptr<SceneLoadTask>       sceneLoad;
+    std::unique_ptr<SceneLoadTask::Part> sceneLoadPart;         // being added, the rest is still parsing
+    size_t                               sceneLoadApplied = 0;  // records of sceneLoadPart added so far
+    float                                sceneLoadProgress = 0; // where sceneLoadPart starts in the file
+    bool                                 sceneLoadCleared = false;
+    std::vector<RTMaterial *>            sceneLoadMaterials;    // ParsedScene::materials of a binary part, interned on first use
+    std::function<void(float)>     onSceneLoadProgress = nullptr;
+    std::function<void(bool)>      onSceneLoadFinished = nullptr;
+
+    std::unique_ptr<SceneSaveTask> sceneSave;
+    std::function<void(bool)>      onSceneSaveFinished = nullptr;
+
+    std::unique_ptr<SceneConvertTask> sceneConvert;
+    std::function<void(bool)>         onSceneConvertFinished = nullptr;
+
+    // Scene being copied out by snapshotPrimitive: each material is formatted once,
+    // the records using it share its text.
+    struct SceneSnapshot {
+        ParsedSceneBuilder builder;
+        std::ostringstream stream;
+        std::unordered_map<const RTMaterial *, ParsedSceneBuilder::TextRange> materialTexts;
+    };
+
+    static constexpr float  INSTANCE_SPACING      = 0.5f; // gap between an object and a new instance of it
+    static constexpr size_t MESH_BUILD_BATCH_SIZE = 1024;
+
+    // world space triangles of a mesh instance being added, created on idle
+    struct MeshBuild {
+        std::shared_ptr<const TriangleMesh> mesh;
+        Transform                           toWorld;
+        RTMaterial                         *material = nullptr;
+        std::string                         sourcePath;
+        uint8_t                             visibility = RAY_VISIBILITY_ALL;
+        Primitives                         *prototype  = nullptr; // set when the build is an instance
+        uint64_t                            group      = NO_SCENE_GROUP; // of a MESH record, joined once built
+        std::vector<Primitives *>           triangles  = {};
+    };
+
+    std::unique_ptr<MeshLoadTask> meshLoad;
+    std::deque<MeshBuild>         meshBuilds; // the front one is built on idle
+    std::function<void(bool)>     onMeshLoadFinished = nullptr;
+    // mesh handle -> file the mesh was imported from, scene files and the journal name it instead of the triangles
+    std::unordered_map<Primitives *, std::string> meshSources;
+    // lights cannot be edited, snapshots reuse the text a loaded light was read from
+    std::unordered_map<const Light *, std::string> lightRecords;
+
+    // prototype -> its instances; they share the prototype's geometry and material
+    std::unordered_map<Primitives *, std::vector<Primitives *>> instances;
+    std::unordered_map<Primitives *, Primitives *>              prototypes; // instance -> prototype
+    // groups are written as `Group <id>`; a new group is named by its prototype's journal id
+    std::unordered_map<Primitives *, uint64_t>                  groupIds;     // prototype -> group id
+    std::unordered_map<uint64_t, Primitives *>                  parsedGroups; // group id in a loaded scene -> prototype
+
+    static constexpr size_t               JOURNAL_COMPACT_ENTRIES  = 4096;
+    static constexpr std::chrono::minutes JOURNAL_COMPACT_INTERVAL{5};
+
+    // ids name objects in the journal, pointers do not survive a restart
+    EditJournal                                journal;
+    bool                                       journalSuspended = false;
+    std::unordered_map<Primitives *, uint64_t> journalIds;
+    uint64_t                                   nextJournalId = 1;
+    std::chrono::steady_clock::time_point      lastJournalCompaction;
 
 public:
     EditorWidget(hui::UI *ui): Container(ui)
@@ -49,16 +147,17 @@ public:
 
         outliner->SetOnSelectChangedAction([this](){ updateRecords(); });
         outliner->SetOnDeleteAction([this](Primitives *deletedObject){ EraseRecord(deletedObject); });
+        viewport3D->SetOnPickAction([this](Primitives *pickedObject){ outliner->SelectRecord(pickedObject); });
         
         auto addObjectDropDown = std::make_unique<Outliner<Primitives *>>(ui);
-        addObjectDropDown->SetSize({100, 80});
+        addObjectDropDown->SetSize({100, 100});
         addObjectDropDown->SetBGColor({61, 61, 61});
         addObjectDropDown->SetRecordButtonMode(Button::Mode::CAPTURE_MODE);
 
         addObjectDropDown->AddRecord(nullptr, "Sphere", 
             [this](){
-                auto sphereMaterial = materialManager.MakeLambertian({0.0f, 0.8f, 1.0f}); 
-                auto sphere = new SphereObject(1.0f, sphereMaterial, &GetSceneManager());
+                auto sphereMaterial = materials.Lambertian({0.0f, 0.8f, 1.0f}); 
+                auto sphere = makePrimitive<SphereObject>(1.0f, sphereMaterial, &GetSceneManager());
                 AddRecord(sphere);
             }, 
             nullptr,
@@ -67,8 +166,8 @@ public:
 
         addObjectDropDown->AddRecord(nullptr, "Plane", 
             [this](){
-                auto planeMaterial = materialManager.MakeLambertian({0.0f, 0.8f, 1.0f}); 
-                auto plane = new PlaneObject({0,0,0}, {0,0,1}, planeMaterial, &GetSceneManager());
+                auto planeMaterial = materials.Lambertian({0.0f, 0.8f, 1.0f}); 
+                auto plane = makePrimitive<PlaneObject>(gm::IPoint3(0, 0, 0), gm::IVec3f(0, 0, 1), planeMaterial, &GetSceneManager());
                 AddRecord(plane);
             }, 
             nullptr,
@@ -77,8 +176,10 @@ public:
 
         addObjectDropDown->AddRecord(nullptr, "Polygon", 
             [this]() {
-                auto material = materialManager.MakeLambertian({0.0f, 0.8f, 1.0f}); 
-                auto polygon = new PolygonObject({{1, 0, 0}, {0, 0, 0}, {0, 0, 1}}, material, &GetSceneManager());
+                auto material = materials.Lambertian({0.0f, 0.8f, 1.0f}); 
+                std::vector<gm::IPoint3> vertices = {{1, 0, 0}, {0, 0, 0}, {0, 0, 1}};
+                auto polygon = makePrimitive<PolygonObject>(vertices, material, &GetSceneManager());
+                viewport3D->SetPolygonVertices(polygon, std::move(vertices));
                 AddRecord(polygon);
             }, 
             nullptr,
@@ -87,14 +188,29 @@ public:
 
         addObjectDropDown->AddRecord(nullptr, "Cube", 
             [this]() {
-                auto material = materialManager.MakeLambertian({0.0f, 0.8f, 1.0f}); 
-                auto cube = new CubeObject({1, 1, 1}, material, &GetSceneManager());
+                auto material = materials.Lambertian({0.0f, 0.8f, 1.0f}); 
+                auto cube = makePrimitive<CubeObject>(gm::IVec3f(1, 1, 1), material, &GetSceneManager());
                 AddRecord(cube);
             }, 
             nullptr,
             static_cast<UI*>(GetUI())->GetTexturePack().outlinerCubeIconPath
         );
 
+        // copy of the selected object next to it, sharing its geometry and material
+        addObjectDropDown->AddRecord(nullptr, "Instance", 
+            [this]() {
+                Primitives *selected = viewport3D->GetSelected();
+                if (!selected) return;
+                selected = viewport3D->GetMeshHandle(selected);
+
+                std::optional<AABB> bounds = viewport3D->GetBounds(selected);
+                float shift = (bounds ? bounds->max.x() - bounds->min.x() + INSTANCE_SPACING : 1.0f);
+                InstantiateRecord(selected, {shift, 0, 0});
+            }, 
+            nullptr,
+            static_cast<UI*>(GetUI())->GetTexturePack().addIconPath
+        );
+
         auto addObjectMenuUnique = std::make_unique<DropDownMenu>(ui);
         addObjectMenuUnique->SetLabel("add");
         addObjectMenuUnique->SetDropDownWidget(std::move(addObjectDropDown));
@@ -109,16 +225,39 @@ public:
 
     void AddRecord(Primitives *object) {
         assert(object);
-        static size_t AddObjectIter = 0; AddObjectIter++;
         viewport3D->AddRecord(object);
-        outliner->AddRecord(object, object->typeString() + std::to_string(AddObjectIter),
-            [object](){ object->setSelectFlag(true); },
-            [object](){ object->setSelectFlag(false); });
+        addOutlinerRecord(object);
+        materials.Acquire(object->material());
+        trackObject(object);
+    }
+
+    // One outliner layout and one scene invalidation for the whole batch.
+    void AddRecords(std::span<Primitives *const> objects) {
+        viewport3D->AddRecords(objects);
+
+        std::vector<Outliner<Primitives *>::RecordInfo> infos;
+        infos.reserve(objects.size());
+        for (auto object : objects) infos.push_back(makeOutlinerRecord(object));
+        outliner->AddRecords(infos);
+
+        for (auto object : objects) {
+            materials.Acquire(object->material());
+            trackObject(object);
+        }
     }
 
     void EraseRecord(Primitives *deletedObject) {
         assert(deletedObject);
+        materials.Release(deletedObject->material());
+        leaveInstanceGroup(deletedObject);
+        // destroys the object, a mesh handle takes its triangles along; only the address is used below
         viewport3D->EraseRecord(deletedObject);
+        meshSources.erase(deletedObject);
+
+        auto it = journalIds.find(deletedObject);
+        if (it == journalIds.end()) return;
+        if (!journalSuspended) journal.AppendErase(it->second);
+        journalIds.erase(it);
     }
 
     void AddLight(::Light *light) {
@@ -128,11 +267,10 @@ public:
 
     void AddRecord(gm::IPoint3 position, Primitives *object) {
         assert(object);
-        static size_t AddObjectIter = 0; AddObjectIter++;
         viewport3D->AddRecord(position, object);
-        outliner->AddRecord(object, object->typeString() + std::to_string(AddObjectIter),
-            [object](){ object->setSelectFlag(true); },
-            [object](){ object->setSelectFlag(false); });
+        addOutlinerRecord(object);
+        materials.Acquire(object->material());
+        trackObject(object);
     }
 
     void AddLight(gm::IPoint3 position, ::Light *light) {
@@ -141,92 +279,179 @@ public:
     }
 
     void ClearRecords() {
+        if (!meshBuilds.empty()) finishMeshImport(false); // their triangles live in the store cleared below
         viewport3D->ClearRecords();
         outliner->ClearRecords();
+        journalIds.clear();
+        meshSources.clear();
+        lightRecords.clear();
+        instances.clear();
+        prototypes.clear();
+        groupIds.clear();
+        parsedGroups.clear();
+        materials.ResetUsers();
     }
 
-    bool SerializeScene(const std::string &path) {
-        std::ofstream file(path, std::ios::out | std::ios::trunc);
-        if (!file) {
-            return false;
-        }
-        for (auto primitive : viewport3D->GetPrimitives()) {
-            file << *primitive << " " << *primitive->material() << "\n";
-        }
-        for (auto light : viewport3D->GetLights()) {
-            file << *light << "\n";
+    // Adds a copy of `prototype` moved by `offset` that shares its geometry and material:
+    // geometry and material edits of any member of the group apply to all of them.
+    // Mesh instances share the mesh buffers and BVH and are built on idle like imports.
+    bool InstantiateRecord(Primitives *object, gm::IVec3f offset) {
+        assert(object);
+        Primitives *prototype = getPrototype(object);
+
+        if (const MeshInstance *mesh = viewport3D->GetMesh(prototype)) {
+            if (IsImportingMesh()) return false;
+            Transform toWorld = mesh->toWorld;
+            toWorld.m[0][3] += offset.x();
+            toWorld.m[1][3] += offset.y();
+            toWorld.m[2][3] += offset.z();
+            auto source = meshSources.find(prototype);
+            meshBuilds.push_back({mesh->mesh, toWorld, prototype->material(), (source == meshSources.end() ? "" : source->second),
+                                  RAY_VISIBILITY_ALL, prototype});
+            return true;
         }
+
+        Primitives *instance = makeInstance(prototype, offset);
+        if (!instance) return false;
+        joinInstanceGroup(prototype, instance);
+        AddRecord(instance);
         return true;
     }
 
-    bool DeserializeScene(const std::string &path) {
-        std::ifstream file(path);
-        if (!file) {
-            return false;
+    // Claims `basePath`, or a numbered sibling if another editor holds it, replays what a
+    // previous run left in it and keeps journaling every edit into it. The file is compacted
+    // to the current scene right away and then periodically on idle.
+    bool EnableAutosave(const std::string &basePath) {
+        std::string journalPath = journal.Claim(basePath);
+        if (journalPath.empty()) return false;
+
+        std::ifstream file(journalPath, std::ios::in | std::ios::binary | std::ios::ate);
+        if (file) {
+            std::vector<char> text(static_cast<size_t>(file.tellg()));
+            file.seekg(0);
+            if (file.read(text.data(), static_cast<std::streamsize>(text.size()))) {
+                replayJournal(ParseJournal({text.data(), text.size()}));
+            }
         }
 
-        std::string line;
-        std::istringstream iss(line);
-        
-        ClearRecords();
-        while (std::getline(file, line)) {
-            deserializeString(line);
+        if (!journal.Open(journalPath)) {
+            std::cerr << "EnableAutosave : failed to open `" << journalPath << "`\n";
+            return false;
         }
+        compactJournal();
         return true;
     }
 
-    void deserializeString(const std::string str) {
-        std::istringstream iss(str);
+    // Parses the file on a background thread and adds the objects of each parsed part in small
+    // batches on idle, so the viewport renders what has arrived while the rest is parsed.
+    // Returns false if a load is already running.
+    bool LoadSceneAsync(const std::string &path,
+                        std::function<void(float progress)> onProgress,
+                        std::function<void(bool success)>   onFinished)
+    {
+        if (sceneLoad) return false;
+
+        sceneLoad = std::make_unique<SceneLoadTask>(path);
+        sceneLoadPart.reset();
+        sceneLoadApplied = 0;
+        sceneLoadProgress = 0;
+        sceneLoadCleared = false;
+        sceneLoadMaterials.clear();
+        onSceneLoadProgress = onProgress;
+        onSceneLoadFinished = onFinished;
+        if (onSceneLoadProgress) onSceneLoadProgress(0);
+        return true;
+    }
 
-        std::string objectName;
-        iss >> objectName;
-        if (objectName == "Sphere") {
-            SphereObject *sphere = new SphereObject(&viewport3D->GetSceneManager());
-            iss >> *sphere;
-            RTMaterial *material = materialManager.deserializeMaterial(iss);
-            sphere->setMaterial(material);
+    // Objects added so far stay in the scene. Returns once the parser has stopped.
+    void CancelSceneLoad() {
+        if (sceneLoad && sceneLoadCleared) compactJournal();
+        sceneLoad.reset();
+        sceneLoadPart.reset();
+        onSceneLoadProgress = nullptr;
+        onSceneLoadFinished = nullptr;
+    }
 
-            AddRecord(sphere);
-            return;        
-        }
-        if (objectName == "Plane") {
-            PlaneObject *plane = new PlaneObject(&viewport3D->GetSceneManager());
-            iss >> *plane;
-            RTMaterial *material = materialManager.deserializeMaterial(iss);
-            plane->setMaterial(material);
+    bool IsLoadingScene() const { return sceneLoad != nullptr; }
 
-            AddRecord(plane);
-            return;        
-        }
+    // Imports an OBJ or binary PLY mesh and builds its BVH on a background thread.
+    // Its triangles are created on idle and the mesh appears as one outliner record.
+    bool ImportMeshAsync(const std::string &path, std::function<void(bool success)> onFinished) {
+        if (IsImportingMesh()) return false;
 
-        if (objectName == "Polygon") {
-            PolygonObject *polygon = new PolygonObject(&viewport3D->GetSceneManager());
-            iss >> *polygon;
-            RTMaterial *material = materialManager.deserializeMaterial(iss);
-            polygon->setMaterial(material);
+        meshLoad = std::make_unique<MeshLoadTask>(path);
+        onMeshLoadFinished = onFinished;
+        return true;
+    }
 
-            AddRecord(polygon);
-            return;        
+    // Also drops the mesh instances and scene meshes that are still being built.
+    void CancelMeshImport() {
+        for (auto &build : meshBuilds) {
+            for (auto triangle : build.triangles) viewport3D->GetPrimitiveStore().Destroy(triangle);
         }
+        meshBuilds.clear();
+        meshLoad.reset();
+        onMeshLoadFinished = nullptr;
+    }
 
-        if (objectName == "Cube") {
-            CubeObject *cube = new CubeObject(&viewport3D->GetSceneManager());
-            iss >> *cube;
-            RTMaterial *material = materialManager.deserializeMaterial(iss);
-            cube->setMaterial(material);
+    bool IsImportingMesh() const { return meshLoad || !meshBuilds.empty(); }
 
-            AddRecord(cube);
-            return;        
-        }
+    // The snapshot is taken here, formatting and writing happen on a worker.
+    // Returns false if a save is already running.
+    bool SaveSceneAsync(const std::string &path, std::function<void(bool success)> onFinished) {
+        if (sceneSave) return false;
 
-         if (objectName == "Light") {
-            Light *light = new Light(&viewport3D->GetSceneManager());
-            iss >> *light;
-            AddLight(light);
-            return;        
-        }
+        sceneSave = std::make_unique<SceneSaveTask>(path, TakeSceneSnapshot());
+        onSceneSaveFinished = onFinished;
+        return true;
+    }
+
+    bool IsSavingScene() const { return sceneSave != nullptr; }
 
-        std::cerr << "deserializeString failed. Unknown objectName : " << objectName << "\n";
+    // The running save still completes, only its report is dropped.
+    void DropSceneSaveCallback() { onSceneSaveFinished = nullptr; }
+
+    // Converts between the text and binary formats on a worker, the scene is not touched.
+    // Returns false if a conversion is already running.
+    bool ConvertSceneAsync(const std::string &srcPath, const std::string &dstPath, std::function<void(bool success)> onFinished) {
+        if (sceneConvert) return false;
+
+        sceneConvert = std::make_unique<SceneConvertTask>(srcPath, dstPath);
+        onSceneConvertFinished = onFinished;
+        return true;
+    }
+
+    bool IsConvertingScene() const { return sceneConvert != nullptr; }
+
+    void DropSceneConvertCallback() { onSceneConvertFinished = nullptr; }
+
+    // Flat copy of the scene: geometry as numbers, materials and lights as their text records,
+    // a mesh as one record naming its file.
+    // `primitives`, if given, receives the object of every record, nullptr for lights.
+    ParsedScene TakeSceneSnapshot(std::vector<Primitives *> *primitives = nullptr) {
+        SceneSnapshot snapshot;
+
+        auto addPrimitive = [&](Primitives *primitive) {
+            if (viewport3D->GetMeshHandle(primitive) != primitive) return; // triangles are in their mesh's record
+            if (snapshotPrimitive(snapshot, primitive) && primitives) primitives->push_back(primitive);
+        };
+        for (auto primitive : viewport3D->GetPrimitives()) addPrimitive(primitive);
+        for (auto primitive : viewport3D->GetHiddenPrimitives()) addPrimitive(primitive);
+
+        for (auto light : viewport3D->GetLights()) {
+            auto loaded = lightRecords.find(light);
+            if (loaded != lightRecords.end()) {
+                snapshot.builder.Add(SceneRecordType::LIGHT, loaded->second);
+            } else {
+                snapshot.stream.str("");
+                snapshot.stream << *light;
+                std::string_view record = snapshot.stream.view();
+                record.remove_prefix(std::min(record.find_first_of(' ') + 1, record.size())); // drop "Light"
+                snapshot.builder.Add(SceneRecordType::LIGHT, record);
+            }
+            if (primitives) primitives->push_back(nullptr);
+        }
+        return snapshot.builder.Finish();
     }
 
     std::vector<::Primitives *> &GetPrimitives() { return viewport3D->GetPrimitives(); }
@@ -234,7 +459,19 @@ public:
     SceneManager &GetSceneManager() { return viewport3D->GetSceneManager(); }
 
 protected:
+    hui::EventResult OnIdle(hui::IdleEvent &evt) override {
+        if (sceneLoad) continueSceneLoad();
+        if (sceneSave) continueSceneSave();
+        if (sceneConvert) continueSceneConvert();
+        if (meshLoad || !meshBuilds.empty()) continueMeshImport();
+        if (!sceneLoad) compactJournalIfDue();
+        // background tasks are polled once per frame
+        if (sceneLoad || sceneSave || sceneConvert || IsImportingMesh()) static_cast<UI*>(GetUI())->RequestFrame();
+        return Container::OnIdle(evt);
+    }
+
     void Redraw() const override {
+        if (!beginLayerRedraw(*this)) return;
         GetTexture().Clear(FULL_TRANSPARENT);
         viewport3D->DrawOn(GetTexture());        
         outliner->DrawOn(GetTexture());
@@ -242,333 +479,920 @@ protected:
     }
 
 private:
-    void layout() {
-        float borderPadding = 30;
-        float innerPadding = 3;
-    
-        float sumWidth = GetUI()->GetWindow()->GetSize().x - borderPadding * 2 - innerPadding;
-        float viewport3DWidth = sumWidth / 3 * 2;
-        float menuWidth = sumWidth - viewport3DWidth - borderPadding;
-        float viewport3DHeight = GetUI()->GetWindow()->GetSize().y - borderPadding * 2;
-        float menuHeight = (viewport3DHeight - innerPadding) / 2;
+    // Adds records [begin, end) of a parsed scene. They are not journaled one by one,
+    // callers compact the journal once the scene is in.
+    // `meshes` are the imported files of scene.meshes. Meshes are queued and built on idle,
+    // unless `created` is given: then they are built right away and `created` receives the
+    // object of every record, nullptr for lights. Records of one group become instances again.
+    void addParsedRecords(const ParsedScene &scene, size_t begin, size_t end, std::span<const ImportedSceneMesh> meshes,
+                          std::vector<Primitives *> *created = nullptr)
+    {
+        assert(begin <= end && end <= scene.records.size());
+        assert(meshes.size() == scene.meshes.size());
+        std::ispanstream recordStream(std::span<char>{});
+
+        std::vector<Primitives *> primitives;
+        primitives.reserve(end - begin);
+
+        for (size_t i = begin; i < end; i++) {
+            const SceneRecord &record = scene.records[i];
+            if (record.type == SceneRecordType::LIGHT) {
+                Light *light = new Light(&viewport3D->GetSceneManager());
+                resetRecordStream(recordStream, record.record) >> *light;
+                AddLight(light);
+                lightRecords.emplace(light, record.record);
+                if (created) created->push_back(nullptr);
+                continue;
+            }
+            if (record.type == SceneRecordType::MESH) {
+                Primitives *handle = addParsedMesh(scene, record, meshes[record.firstVertex], created != nullptr);
+                if (created) created->push_back(handle);
+                continue;
+            }
+
+            std::span<const BinaryVertex> vertices(scene.vertices.data() + record.firstVertex, record.vertexCount);
+            primitives.push_back(makeParsedPrimitive(record.type, record.position, record.params, vertices, parsedMaterial(scene, record)));
+            if (created) created->push_back(primitives.back());
+        }
 
-        viewport3D->SetSize({viewport3DWidth, viewport3DHeight});
-        outliner->SetSize({menuWidth, menuHeight});
-        propertiesPanel->SetSize({menuWidth, menuHeight});
+        bool wasSuspended = std::exchange(journalSuspended, true);
+        AddRecords(primitives);
+
+        // visibility may move objects out of the scene, so it goes after they are added
+        size_t primitiveIndex = 0;
+        for (size_t i = begin; i < end; i++) {
+            const SceneRecord &record = scene.records[i];
+            if (record.type == SceneRecordType::LIGHT || record.type == SceneRecordType::MESH) continue;
+            Primitives *primitive = primitives[primitiveIndex++];
+            if (record.visibility != RAY_VISIBILITY_ALL) viewport3D->SetVisibility(primitive, record.visibility);
+            joinParsedGroup(primitive, record.group);
+        }
+        journalSuspended = wasSuspended;
+    }
 
-        viewport3D->SetPos({borderPadding, borderPadding});
-        outliner->SetPos({viewport3D->GetPos().x + viewport3D->GetSize().x + innerPadding, viewport3D->GetPos().y});
-        propertiesPanel->SetPos(outliner->GetPos() + dr4::Vec2f(0, menuHeight + innerPadding));
+    void continueSceneLoad() {
+        using Clock = std::chrono::steady_clock;
+        Clock::time_point deadline = Clock::now() + std::chrono::duration<double>(SCENE_LOAD_BUDGET_SECS);
+        do {
+            if (!sceneLoadPart) {
+                // read before taking: once the state is final, no part can arrive after an empty take
+                SceneLoadTask::State state = sceneLoad->GetState();
+                sceneLoadPart = sceneLoad->TakePart();
+                if (!sceneLoadPart) {
+                    if (state == SceneLoadTask::State::PARSING) break;
+                    // the previous scene is kept if the file can't be read, an empty file clears it
+                    if (state == SceneLoadTask::State::READY && !sceneLoadCleared) {
+                        ClearRecords();
+                        sceneLoadCleared = true;
+                    }
+                    finishSceneLoad(state == SceneLoadTask::State::READY);
+                    return;
+                }
+                sceneLoadApplied = 0;
+                sceneLoadMaterials.clear();
+                if (!sceneLoadCleared) ClearRecords();
+                sceneLoadCleared = true;
+            }
+
+            const ParsedScene &scene = sceneLoadPart->scene;
+            size_t end = std::min(sceneLoadApplied + SCENE_LOAD_BATCH_SIZE, scene.records.size());
+            addParsedRecords(scene, sceneLoadApplied, end, sceneLoadPart->meshes);
+            sceneLoadApplied = end;
+            if (sceneLoadApplied == scene.records.size()) {
+                sceneLoadProgress = sceneLoadPart->progress;
+                sceneLoadPart.reset();
+            }
+        } while (Clock::now() < deadline);
+
+        if (onSceneLoadProgress) {
+            float progress = sceneLoadProgress;
+            if (sceneLoadPart && !sceneLoadPart->scene.records.empty()) {
+                float applied = static_cast<float>(sceneLoadApplied) / sceneLoadPart->scene.records.size();
+                progress += (sceneLoadPart->progress - sceneLoadProgress) * applied;
+            }
+            onSceneLoadProgress(progress);
+        }
     }
 
-    void updateRecords() {
-        auto selectedObject = outliner->GetSelected();
-        propertiesPanel->ClearRecords();
+    void finishSceneLoad(bool success) {
+        auto onFinished = std::move(onSceneLoadFinished);
+        if (success && onSceneLoadProgress) onSceneLoadProgress(1);
+        CancelSceneLoad();
+        if (onFinished) onFinished(success);
+    }
 
-        if (selectedObject.has_value()) {
-            addCordsProperties(selectedObject->second);
-            addMaterialProperties(selectedObject->second);
-            addSpecialProperties(selectedObject->second);
+    // Text records are interned by their text. Binary scenes store each material once, it is
+    // formatted for the manager's reader on first use and looked up by index afterwards.
+    RTMaterial *parsedMaterial(const ParsedScene &scene, const SceneRecord &record) {
+        if (record.material == NO_SCENE_MATERIAL) return materials.Intern(record.record);
+
+        sceneLoadMaterials.resize(scene.materials.size(), nullptr);
+        RTMaterial *&material = sceneLoadMaterials[record.material];
+        if (!material) {
+            std::vector<char> text;
+            FormatSceneMaterial(scene.materials[record.material], text);
+            material = materials.Intern({text.data(), text.size()});
         }
+        return material;
+    }
 
-        ForceRedraw();
+    Primitives *makeParsedPrimitive(SceneRecordType type, const float (&position)[3], const float (&params)[3],
+                                    std::span<const BinaryVertex> vertices, RTMaterial *material)
+    {
+        SceneManager &sceneManager = viewport3D->GetSceneManager();
+        gm::IPoint3 pos(position[0], position[1], position[2]);
+
+        Primitives *primitive = nullptr;
+        switch (type) {
+        case SceneRecordType::SPHERE:
+            primitive = makePrimitive<SphereObject>(params[0], material, &sceneManager);
+            primitive->setPosition(pos);
+            break;
+        case SceneRecordType::PLANE:
+            primitive = makePrimitive<PlaneObject>(pos, gm::IVec3f(params[0], params[1], params[2]), material, &sceneManager);
+            break;
+        case SceneRecordType::CUBE:
+            primitive = makePrimitive<CubeObject>(gm::IVec3f(params[0], params[1], params[2]), material, &sceneManager);
+            primitive->setPosition(pos);
+            break;
+        case SceneRecordType::POLYGON: {
+            std::vector<gm::IPoint3> points;
+            points.reserve(vertices.size());
+            for (const auto &v : vertices) points.emplace_back(v.position[0], v.position[1], v.position[2]);
+            primitive = makePrimitive<PolygonObject>(points, material, &sceneManager);
+            viewport3D->SetPolygonVertices(primitive, std::move(points));
+            break;
+        }
+        case SceneRecordType::MESH:
+        case SceneRecordType::LIGHT:
+            assert(0);
+            break;
+        }
+        return primitive;
     }
 
-    void addCordsProperties(::Primitives *selectedObject) {
-        assert(selectedObject);
-    
-        std::string XLabel = "Location X";
-        std::string YLabel = "                 Y";
-        std::string ZLabel = "                 Z";
-    
-        std::string XContent = std::to_string(selectedObject->position().x());
-        std::string YContent = std::to_string(selectedObject->position().y());
-        std::string ZContent = std::to_string(selectedObject->position().z());
-
-        std::function<void(const std::string &newCord)> XCordFunction = 
-        [selectedObject](const std::string &newCord)
-        {
-            setIfStringConvertedToFloat(newCord, [selectedObject](float val) {
-                auto pos = selectedObject->position();
-                pos.setY(val);
-                selectedObject->setPosition(pos);
-            });
+    // Queues the mesh of a MESH record, or builds it right away when `now` is set.
+    Primitives *addParsedMesh(const ParsedScene &scene, const SceneRecord &record, const ImportedSceneMesh &imported, bool now) {
+        if (!imported.mesh) return nullptr;
+
+        const SceneMesh &sceneMesh = scene.meshes[record.firstVertex];
+        MeshBuild build = {imported.mesh, {}, parsedMaterial(scene, record), imported.path, record.visibility, nullptr, record.group};
+        std::copy(sceneMesh.toWorld, sceneMesh.toWorld + 12, &build.toWorld.m[0][0]);
+
+        if (!now) {
+            meshBuilds.push_back(std::move(build));
+            return nullptr;
+        }
+        buildMeshTriangles(*build.mesh, build.toWorld, build.material, build.triangles, build.mesh->GetTriangleCount());
+        return completeMeshBuild(build);
+    }
+
+    Outliner<Primitives *>::RecordInfo makeOutlinerRecord(Primitives *object) {
+        assert(object);
+        addedObjectCount++;
+        // the callbacks resolve a handle, so a record outliving its object cannot reach a reused slot
+        PrimitiveHandle handle = viewport3D->GetPrimitiveStore().GetHandle(object);
+        auto resolve = [this, handle, object]() {
+            return (handle.IsNull() ? object : viewport3D->GetPrimitiveStore().Get(handle));
         };
-    
-        std::function<void(const std::string &newCord)> YCordFunction = 
-        [selectedObject](const std::string &newCord)
-        {
-            setIfStringConvertedToFloat(newCord, [selectedObject](float val) {
-                auto pos = selectedObject->position();
-                pos.setY(val);
-                selectedObject->setPosition(pos);
-            });
+        return {
+            object,
+            object->typeString() + std::to_string(addedObjectCount),
+            [this, resolve](){ if (auto live = resolve()) viewport3D->SetSelected(live); },
+            [this, resolve](){
+                auto live = resolve();
+                if (live && viewport3D->GetSelected() == live) viewport3D->SetSelected(nullptr);
+            }
         };
-    
-        std::function<void(const std::string &newCord)> ZCordFunction = 
-        [selectedObject](const std::string &newCord)
-        {
-            setIfStringConvertedToFloat(newCord, [selectedObject](float val) {
-                auto pos = selectedObject->position();
-                pos.setZ(val);
-                selectedObject->setPosition(pos);
-            });
+    }
+
+    void addOutlinerRecord(Primitives *object) {
+        auto info = makeOutlinerRecord(object);
+        outliner->AddRecord(info.object, info.name, info.onSelect, info.onUnSelect, info.iconPath);
+    }
+
+    // Points a reusable stream at a record so per-line stream construction is avoided.
+    // ispanstream only reads, so dropping const here is safe.
+    static std::istream &resetRecordStream(std::ispanstream &stream, std::string_view record) {
+        stream.clear();
+        stream.span(std::span<char>(const_cast<char *>(record.data()), record.size()));
+        return stream;
+    }
+
+    bool snapshotPrimitive(SceneSnapshot &snapshot, ::Primitives *primitive) {
+        assert(primitive);
+        auto [materialText, firstUse] = snapshot.materialTexts.try_emplace(primitive->material());
+        if (firstUse) {
+            // interned materials keep their text, only others are formatted here
+            const std::string *record = materials.GetRecord(primitive->material());
+            if (!record) {
+                snapshot.stream.str("");
+                snapshot.stream << *primitive->material();
+            }
+            materialText->second = snapshot.builder.AddText(record ? std::string_view(*record) : snapshot.stream.view());
+        }
+
+        auto add = [&](SceneRecordType type) -> SceneRecord & {
+            SceneRecord &record = snapshot.builder.Add(type, materialText->second);
+            gm::IPoint3 position = primitive->position();
+            record.position[0] = position.x();
+            record.position[1] = position.y();
+            record.position[2] = position.z();
+            record.visibility = viewport3D->GetVisibility(primitive);
+            record.group = getInstanceGroupId(primitive);
+            return record;
         };
-    
-        auto transformProperty = std::make_unique<roa::Property>(GetUI());
-        transformProperty->SetLabel("Transform");
-        transformProperty->AddPropertyField(XLabel, XContent, XCordFunction);
-        transformProperty->AddPropertyField(YLabel, YContent, YCordFunction);
-        transformProperty->AddPropertyField(ZLabel, ZContent, ZCordFunction);
 
-        propertiesPanel->AddProperty(std::move(transformProperty));
+        if (auto sphere = dynamic_cast<SphereObject *>(primitive)) {
+            add(SceneRecordType::SPHERE).params[0] = sphere->getRadius();
+            return true;
+        }
+        if (auto plane = dynamic_cast<PlaneObject *>(primitive)) {
+            SceneRecord &record = add(SceneRecordType::PLANE);
+            auto normal = plane->getNormal();
+            record.params[0] = normal.x(); record.params[1] = normal.y(); record.params[2] = normal.z();
+            return true;
+        }
+        if (auto cube = dynamic_cast<CubeObject *>(primitive)) {
+            SceneRecord &record = add(SceneRecordType::CUBE);
+            auto halfSize = cube->getHalfSize();
+            record.params[0] = halfSize.x(); record.params[1] = halfSize.y(); record.params[2] = halfSize.z();
+            return true;
+        }
+        if (const MeshInstance *mesh = viewport3D->GetMesh(primitive)) {
+            auto source = meshSources.find(primitive);
+            if (source == meshSources.end() || source->second.find('\n') != std::string::npos) {
+                std::cerr << "snapshotPrimitive : mesh `" << (source == meshSources.end() ? "" : source->second)
+                          << "` cannot be stored\n";
+                return false;
+            }
+            SceneRecord &record = add(SceneRecordType::MESH);
+            record.firstVertex = snapshot.builder.AddMesh(std::span<const float, 12>(&mesh->toWorld.m[0][0], 12), source->second);
+            return true;
+        }
+        if (auto polygon = dynamic_cast<PolygonObject *>(primitive)) {
+            // the viewport caches the vertices of every polygon record, the record is parsed only without them
+            std::span<const gm::IPoint3> vertices = viewport3D->GetPolygonVertices(polygon);
+            std::vector<gm::IPoint3> parsed;
+            if (vertices.empty()) vertices = parsed = ExtractPolygonVertices(polygon);
+
+            SceneRecord &record = add(SceneRecordType::POLYGON);
+            record.firstVertex = snapshot.builder.GetVertexCount();
+            record.vertexCount = static_cast<uint32_t>(vertices.size());
+            for (const auto &v : vertices) snapshot.builder.AddVertex(v.x(), v.y(), v.z());
+            return true;
+        }
+
+        std::cerr << "snapshotPrimitive : unsupported primitive " << primitive->typeString() << "\n";
+        return false;
     }
-    void addMaterialProperties(::Primitives *selectedObject) {
-        assert(selectedObject);
 
-        auto diffuseProperty  = std::make_unique<roa::Property>(GetUI());
-        auto specularProperty = std::make_unique<roa::Property>(GetUI());
-        auto emittedProperty  = std::make_unique<roa::Property>(GetUI());
-    
-        fillSpecularProperty(selectedObject, specularProperty.get());
-        fillDiffuseProperty(selectedObject, diffuseProperty.get());
-        fillEmittedProperty(selectedObject, emittedProperty.get());
+    // Gives a new object its journal id and logs it unless it arrives with a whole loaded scene.
+    void trackObject(Primitives *object) {
+        uint64_t id = nextJournalId++;
+        journalIds[object] = id;
+        if (journalSuspended || !journal.IsOpen()) return;
+
+        SceneSnapshot snapshot;
+        if (!snapshotPrimitive(snapshot, object)) return;
 
-        propertiesPanel->AddProperty(std::move(diffuseProperty));
-        propertiesPanel->AddProperty(std::move(specularProperty));
-        propertiesPanel->AddProperty(std::move(emittedProperty));
+        ParsedScene scene = snapshot.builder.Finish();
+        std::vector<char> line;
+        FormatSceneRecord(scene, scene.records.front(), line);
+        journal.AppendAdd(id, {line.data(), line.size()});
     }
 
-    void addSpecialProperties(::Primitives *selectedObject) {
-        ::SphereObject *sphere = dynamic_cast<::SphereObject *>(selectedObject);
-        if (sphere) {
-            auto sphereProperty = std::make_unique<roa::Property>(GetUI());
-            fillSphereProperty(sphere, sphereProperty.get());
-            propertiesPanel->AddProperty(std::move(sphereProperty));
-            return;
+    // Rewrites the journal as the current scene, the edits logged so far are folded into it.
+    // Only the snapshot is taken here, the journal's writer thread formats it.
+    void compactJournal() {
+        lastJournalCompaction = std::chrono::steady_clock::now();
+        if (!journal.IsOpen()) return;
+
+        std::vector<Primitives *> primitives;
+        ParsedScene scene = TakeSceneSnapshot(&primitives);
+
+        std::vector<uint64_t> ids;
+        ids.reserve(primitives.size());
+        for (auto primitive : primitives) {
+            auto it = (primitive ? journalIds.find(primitive) : journalIds.end());
+            ids.push_back(it == journalIds.end() ? 0 : it->second);
         }
 
-        ::PlaneObject *plane = dynamic_cast<::PlaneObject *>(selectedObject);
-        if (plane) {
-            auto planeProperty = std::make_unique<roa::Property>(GetUI());
-            fillPlaneProperty(plane, planeProperty.get());
-            propertiesPanel->AddProperty(std::move(planeProperty));
-            return;
+        // std::function copies its callable; the scene is shared, a copy would leave its views behind
+        auto shared = std::make_shared<const ParsedScene>(std::move(scene));
+        journal.Compact([scene = std::move(shared), ids = std::move(ids)](std::vector<char> &lines) {
+            std::vector<char> line;
+            for (size_t i = 0; i < scene->records.size(); i++) {
+                line.clear();
+                FormatSceneRecord(*scene, scene->records[i], line);
+                FormatJournalAdd(ids[i], {line.data(), line.size()}, lines);
+            }
+        });
+    }
+
+    void replayJournal(const std::vector<JournalEntry> &entries) {
+        if (entries.empty()) return;
+
+        ClearRecords();
+        bool wasSuspended = std::exchange(journalSuspended, true);
+        // journal id of the previous run -> objects
+        std::unordered_map<uint64_t, std::vector<Primitives *>> objects;
+
+        for (size_t i = 0; i < entries.size();) {
+            const JournalEntry &entry = entries[i];
+
+            if (entry.kind == JournalEntry::Kind::ADD) {
+                // consecutive adds, e.g. the compacted head, are parsed as one text scene
+                size_t end = i;
+                std::vector<char> text;
+                for (; end < entries.size() && entries[end].kind == JournalEntry::Kind::ADD; end++) {
+                    text.insert(text.end(), entries[end].record.begin(), entries[end].record.end());
+                    text.push_back('\n');
+                }
+                replayAdds(std::span(entries).subspan(i, end - i), std::move(text), objects);
+                i = end;
+                continue;
+            }
+
+            if (entry.kind == JournalEntry::Kind::ERASE) {
+                // consecutive erases leave the outliner in one pass, before the objects are destroyed
+                std::vector<Primitives *> erased;
+                for (; i < entries.size() && entries[i].kind == JournalEntry::Kind::ERASE; i++) {
+                    auto it = objects.find(entries[i].objectId);
+                    if (it == objects.end()) continue;
+                    erased.insert(erased.end(), it->second.begin(), it->second.end());
+                    objects.erase(it);
+                }
+                outliner->EraseRecords(erased);
+                for (auto object : erased) EraseRecord(object);
+                continue;
+            }
+
+            auto it = objects.find(entry.objectId);
+            if (it != objects.end()) {
+                if (entry.kind == JournalEntry::Kind::GROUP) {
+                    parsedGroups[entry.objectId] = it->second.front();
+                } else {
+                    if (isMaterialField(entry.field)) unshareMaterial(it->second);
+                    for (auto object : it->second) {
+                        applySceneField(object, entry.field, entry.value);
+                        viewport3D->InvalidateObject(object);
+                    }
+                    if (isMaterialField(entry.field)) materials.FinishEdit(it->second.front()->material());
+                }
+            }
+            i++;
         }
 
-        ::CubeObject *cube = dynamic_cast<::CubeObject *>(selectedObject);
-        if (cube) {
-            auto cubeProperty = std::make_unique<roa::Property>(GetUI());
-            fillCubeProperty(cube, cubeProperty.get());
-            propertiesPanel->AddProperty(std::move(cubeProperty));
-            return;
+        // replayed groups got their ids from the new journal ids, the old ones are not used again
+        parsedGroups.clear();
+        journalSuspended = wasSuspended;
+        viewport3D->InvalidateFrame();
+    }
+
+    void replayAdds(std::span<const JournalEntry> adds, std::vector<char> text,
+                    std::unordered_map<uint64_t, std::vector<Primitives *>> &objects)
+    {
+        // mesh paths are journaled absolute; replay runs once before the editor is used,
+        // so their files are imported right here instead of on a SceneLoadTask
+        ParsedScene scene;
+        ParseSceneText(std::move(text), scene);
+
+        std::vector<Primitives *> created;
+        if (scene.records.size() == adds.size()) {
+            addParsedRecords(scene, 0, scene.records.size(), ImportSceneMeshes(scene, {}), &created);
+        } else {
+            // a malformed line shifted the records, fall back to one line at a time
+            for (const auto &add : adds) {
+                ParsedScene line;
+                ParseSceneText(std::vector<char>(add.record.begin(), add.record.end()), line, 1);
+                if (line.records.size() == 1) addParsedRecords(line, 0, 1, ImportSceneMeshes(line, {}), &created);
+                else created.push_back(nullptr);
+            }
+        }
+
+        for (size_t i = 0; i < adds.size(); i++) {
+            if (created[i] && adds[i].objectId != 0) objects[adds[i].objectId].push_back(created[i]);
         }
     }
 
-    void fillSpecularProperty(::Primitives *selectedObject, roa::Property *specularProperty) {
-        assert(selectedObject);
-        assert(specularProperty);
+    void applySceneField(Primitives *object, SceneField field, float value) {
+        assert(object);
+        auto setComponent = [](auto vector, int axis, float v) {
+            if (axis == 0) vector.setX(v);
+            else if (axis == 1) vector.setY(v);
+            else vector.setZ(v);
+            return vector;
+        };
 
-        auto &m = *selectedObject->material();
+        switch (field) {
+        case SceneField::POSITION_X:
+        case SceneField::POSITION_Y:
+        case SceneField::POSITION_Z:
+            object->setPosition(setComponent(object->position(), static_cast<int>(field) - static_cast<int>(SceneField::POSITION_X), value));
+            break;
+        case SceneField::DIFFUSE_X:  object->material()->diffuse().setX(value);  break;
+        case SceneField::DIFFUSE_Y:  object->material()->diffuse().setY(value);  break;
+        case SceneField::DIFFUSE_Z:  object->material()->diffuse().setZ(value);  break;
+        case SceneField::SPECULAR_X: object->material()->specular().setX(value); break;
+        case SceneField::SPECULAR_Y: object->material()->specular().setY(value); break;
+        case SceneField::SPECULAR_Z: object->material()->specular().setZ(value); break;
+        case SceneField::EMITTED_X:  object->material()->emitted().setX(value);  break;
+        case SceneField::EMITTED_Y:  object->material()->emitted().setY(value);  break;
+        case SceneField::EMITTED_Z:  object->material()->emitted().setZ(value);  break;
+        case SceneField::RADIUS:
+            if (auto sphere = dynamic_cast<SphereObject *>(object)) sphere->setRadius(value);
+            break;
+        case SceneField::HALF_SIZE_X:
+        case SceneField::HALF_SIZE_Y:
+        case SceneField::HALF_SIZE_Z:
+            if (auto cube = dynamic_cast<CubeObject *>(object)) {
+                int axis = static_cast<int>(field) - static_cast<int>(SceneField::HALF_SIZE_X);
+                cube->setHalfSize(setComponent(cube->getHalfSize(), axis, value));
+            }
+            break;
+        case SceneField::NORMAL_X:
+        case SceneField::NORMAL_Y:
+        case SceneField::NORMAL_Z:
+            if (auto plane = dynamic_cast<PlaneObject *>(object)) {
+                int axis = static_cast<int>(field) - static_cast<int>(SceneField::NORMAL_X);
+                plane->setNormal(setComponent(plane->getNormal(), axis, value));
+            }
+            break;
+        case SceneField::VISIBILITY:
+            viewport3D->SetVisibility(object, static_cast<uint8_t>(value));
+            break;
+        case SceneField::COUNT:
+            assert(0);
+            break;
+        }
+    }
 
-        std::string XLabel = "Specular X";
-        std::string YLabel = "                 Y";
-        std::string ZLabel = "                 Z";
+    void continueMeshImport() {
+        if (meshLoad) {
+            MeshLoadTask::State state = meshLoad->GetState();
+            if (state == MeshLoadTask::State::LOADING) return;
+            if (state == MeshLoadTask::State::FAILED) {
+                finishMeshImport(false);
+                return;
+            }
+            // all triangles share one material, editing it recolors the whole mesh
+            meshBuilds.push_back({meshLoad->GetMesh(), {}, materials.Lambertian({0.0f, 0.8f, 1.0f}), meshLoad->GetPath()});
+            meshLoad.reset();
+        }
 
-        std::string XContent = std::to_string(m.specular().x());
-        std::string YContent = std::to_string(m.specular().y());
-        std::string ZContent = std::to_string(m.specular().z());
+        MeshBuild &build = meshBuilds.front();
+        size_t triangleCount = build.mesh->GetTriangleCount();
 
-        auto setX = [selectedObject](const std::string &s){
-            setIfStringConvertedToFloat(s, [selectedObject](float v){
-                selectedObject->material()->specular().setX(v);
-            });
-        };
-        auto setY = [selectedObject](const std::string &s){
-            setIfStringConvertedToFloat(s, [selectedObject](float v){
-                selectedObject->material()->specular().setY(v);
-            });
-        };
-        auto setZ = [selectedObject](const std::string &s){
-            setIfStringConvertedToFloat(s, [selectedObject](float v){
-                selectedObject->material()->specular().setZ(v);
-            });
+        using Clock = std::chrono::steady_clock;
+        Clock::time_point deadline = Clock::now() + std::chrono::duration<double>(SCENE_LOAD_BUDGET_SECS);
+        do {
+            size_t end = std::min(build.triangles.size() + MESH_BUILD_BATCH_SIZE, triangleCount);
+            buildMeshTriangles(*build.mesh, build.toWorld, build.material, build.triangles, end);
+        } while (build.triangles.size() < triangleCount && Clock::now() < deadline);
+
+        if (build.triangles.size() < triangleCount) return;
+        completeMeshBuild(build);
+        meshBuilds.pop_front();
+        if (meshBuilds.empty()) finishMeshImport(true);
+    }
+
+    void finishMeshImport(bool success) {
+        auto onFinished = std::move(onMeshLoadFinished);
+        CancelMeshImport();
+        if (onFinished) onFinished(success);
+    }
+
+    // Adds the mesh of a build whose triangles are all made.
+    Primitives *completeMeshBuild(MeshBuild &build) {
+        // the prototype's material may have been copied on write while the instance was built
+        RTMaterial *material = (build.prototype ? build.prototype->material() : build.material);
+        if (material != build.material) {
+            for (auto triangle : build.triangles) triangle->setMaterial(material);
+        }
+        Primitives *handle = addMesh(build.mesh, std::move(build.triangles), build.toWorld, build.sourcePath, build.visibility);
+        if (build.prototype && viewport3D->GetMesh(build.prototype)) joinInstanceGroup(build.prototype, handle);
+        else joinParsedGroup(handle, build.group);
+        // one `Mesh` line naming the file instead of an `A` line per triangle, with its group
+        trackObject(handle);
+        build.triangles.clear();
+        return handle;
+    }
+
+    // Appends the world space triangles [triangles.size(), end) of `mesh`.
+    void buildMeshTriangles(const TriangleMesh &mesh, const Transform &toWorld, RTMaterial *material,
+                            std::vector<Primitives *> &triangles, size_t end)
+    {
+        std::span<const MeshVertex> vertices = mesh.GetVertices();
+        std::span<const uint32_t>   indices  = mesh.GetIndices();
+        auto point = [&vertices, &toWorld](uint32_t index) {
+            float p[3];
+            toWorld.ApplyToPoint(vertices[index].position, p);
+            return gm::IPoint3(p[0], p[1], p[2]);
         };
 
-        specularProperty->SetLabel("Specular");
-        specularProperty->AddPropertyField(XLabel, XContent, setX);
-        specularProperty->AddPropertyField(YLabel, YContent, setY);
-        specularProperty->AddPropertyField(ZLabel, ZContent, setZ);
+        for (size_t t = triangles.size(); t < end; t++) {
+            std::vector<gm::IPoint3> corners = {point(indices[t * 3]), point(indices[t * 3 + 1]), point(indices[t * 3 + 2])};
+            triangles.push_back(makePrimitive<PolygonObject>(corners, material, &GetSceneManager()));
+        }
     }
-    void fillDiffuseProperty(::Primitives *selectedObject, roa::Property *diffuseProperty) {
-        assert(selectedObject);
-        assert(diffuseProperty);
 
-        auto &m = *selectedObject->material();
+    Primitives *addMesh(std::shared_ptr<const TriangleMesh> mesh, std::vector<Primitives *> triangles, const Transform &toWorld,
+                        const std::string &sourcePath, uint8_t visibility)
+    {
+        Primitives *handle = triangles.front();
+        viewport3D->AddMesh(std::move(mesh), std::move(triangles), toWorld);
+        if (visibility != RAY_VISIBILITY_ALL) viewport3D->SetVisibility(handle, visibility);
+
+        auto info = makeOutlinerRecord(handle);
+        info.name = "Mesh" + std::to_string(addedObjectCount);
+        info.iconPath = static_cast<UI*>(GetUI())->GetTexturePack().outlinerObMeshSvgPath;
+        outliner->AddRecords(std::span(&info, 1));
+        materials.Acquire(handle->material());
+
+        // scenes and the journal may be read from another working directory
+        std::error_code ec;
+        std::filesystem::path absolutePath = std::filesystem::absolute(sourcePath, ec);
+        meshSources[handle] = (ec ? sourcePath : absolutePath.string());
+        return handle;
+    }
 
-        std::string XLabel = "Diffuse X";
-        std::string YLabel = "              Y";
-        std::string ZLabel = "              Z";
+    Primitives *getPrototype(Primitives *object) const {
+        auto it = prototypes.find(object);
+        return (it == prototypes.end() ? object : it->second);
+    }
 
-        std::string XContent = std::to_string(m.diffuse().x());
-        std::string YContent = std::to_string(m.diffuse().y());
-        std::string ZContent = std::to_string(m.diffuse().z());
+    // `object` with the prototype and instances it shares geometry with
+    std::vector<Primitives *> getInstanceGroup(Primitives *object) const {
+        Primitives *prototype = getPrototype(object);
+        std::vector<Primitives *> group = {prototype};
+        auto it = instances.find(prototype);
+        if (it != instances.end()) group.insert(group.end(), it->second.begin(), it->second.end());
+        return group;
+    }
 
-        auto setX = [selectedObject](const std::string &s){
-            setIfStringConvertedToFloat(s, [selectedObject](float v){
-                selectedObject->material()->diffuse().setX(v);
-            });
-        };
-        auto setY = [selectedObject](const std::string &s){
-            setIfStringConvertedToFloat(s, [selectedObject](float v){
-                selectedObject->material()->diffuse().setY(v);
-            });
-        };
-        auto setZ = [selectedObject](const std::string &s){
-            setIfStringConvertedToFloat(s, [selectedObject](float v){
-                selectedObject->material()->diffuse().setZ(v);
-            });
-        };
+    // Id written as `Group <id>` for `object`, NO_SCENE_GROUP if it has no instances.
+    uint64_t getInstanceGroupId(Primitives *object) const {
+        auto it = groupIds.find(getPrototype(object));
+        return (it == groupIds.end() ? NO_SCENE_GROUP : it->second);
+    }
 
-        diffuseProperty->SetLabel("Diffuse");
-        diffuseProperty->AddPropertyField(XLabel, XContent, setX);
-        diffuseProperty->AddPropertyField(YLabel, YContent, setY);
-        diffuseProperty->AddPropertyField(ZLabel, ZContent, setZ);
+    // A new group is journaled before its first instance, whose `A` line names it.
+    void joinInstanceGroup(Primitives *prototype, Primitives *instance) {
+        assert(prototypes.find(prototype) == prototypes.end());
+        if (!groupIds.contains(prototype)) {
+            auto id = journalIds.find(prototype);
+            assert(id != journalIds.end());
+            groupIds[prototype] = id->second;
+            if (!journalSuspended) journal.AppendGroup(id->second);
+        }
+        instances[prototype].push_back(instance);
+        prototypes[instance] = prototype;
     }
-    void fillEmittedProperty(::Primitives *selectedObject, roa::Property *emittedProperty) {
-        assert(selectedObject);
-        assert(emittedProperty);
 
-        auto &m = *selectedObject->material();
+    // The first object of a loaded group becomes its prototype. Members with another
+    // material than the prototype's stay on their own, instances share one material.
+    void joinParsedGroup(Primitives *object, uint64_t group) {
+        if (!object || group == NO_SCENE_GROUP) return;
+        auto [it, first] = parsedGroups.try_emplace(group, object);
+        if (first || it->second->material() != object->material()) return;
+        joinInstanceGroup(it->second, object);
+    }
 
-        std::string XLabel = "Emitted X";
-        std::string YLabel = "              Y";
-        std::string ZLabel = "              Z";
+    // An erased prototype hands the group, with its id, over to its first instance.
+    void leaveInstanceGroup(Primitives *object) {
+        for (auto &build : meshBuilds) {
+            if (build.prototype == object) build.prototype = nullptr;
+        }
+
+        auto prototypeIt = prototypes.find(object);
+        if (prototypeIt != prototypes.end()) {
+            std::vector<Primitives *> &group = instances[prototypeIt->second];
+            std::erase(group, object);
+            if (group.empty()) {
+                instances.erase(prototypeIt->second);
+                groupIds.erase(prototypeIt->second);
+            }
+            prototypes.erase(prototypeIt);
+            return;
+        }
 
-        std::string XContent = std::to_string(m.emitted().x());
-        std::string YContent = std::to_string(m.emitted().y());
-        std::string ZContent = std::to_string(m.emitted().z());
+        auto groupIt = instances.find(object);
+        if (groupIt == instances.end()) {
+            std::erase_if(parsedGroups, [object](const auto &entry) { return entry.second == object; });
+            return;
+        }
+        std::vector<Primitives *> group = std::move(groupIt->second);
+        instances.erase(groupIt);
+
+        Primitives *newPrototype = group.front();
+        prototypes.erase(newPrototype);
+        for (size_t i = 1; i < group.size(); i++) prototypes[group[i]] = newPrototype;
+        if (group.size() > 1) instances[newPrototype].assign(group.begin() + 1, group.end());
+
+        auto id = groupIds.extract(object);
+        if (id && group.size() > 1) groupIds[newPrototype] = id.mapped();
+        for (auto &entry : parsedGroups) {
+            if (entry.second == object) entry.second = newPrototype;
+        }
+    }
 
-        auto setX = [selectedObject](const std::string &s){
-            setIfStringConvertedToFloat(s, [selectedObject](float v){
-                selectedObject->material()->emitted().setX(v);
-            });
-        };
-        auto setY = [selectedObject](const std::string &s){
-            setIfStringConvertedToFloat(s, [selectedObject](float v){
-                selectedObject->material()->emitted().setY(v);
-            });
-        };
-        auto setZ = [selectedObject](const std::string &s){
-            setIfStringConvertedToFloat(s, [selectedObject](float v){
-                selectedObject->material()->emitted().setZ(v);
-            });
+    Primitives *makeInstance(Primitives *prototype, gm::IVec3f offset) {
+        SceneManager &sceneManager = viewport3D->GetSceneManager();
+        RTMaterial *material = prototype->material();
+        auto moved = [&offset](const gm::IPoint3 &p) {
+            return gm::IPoint3(p.x() + offset.x(), p.y() + offset.y(), p.z() + offset.z());
         };
+        gm::IPoint3 position = moved(prototype->position());
+
+        if (auto sphere = dynamic_cast<SphereObject *>(prototype)) {
+            auto instance = makePrimitive<SphereObject>(sphere->getRadius(), material, &sceneManager);
+            instance->setPosition(position);
+            return instance;
+        }
+        if (auto cube = dynamic_cast<CubeObject *>(prototype)) {
+            auto instance = makePrimitive<CubeObject>(cube->getHalfSize(), material, &sceneManager);
+            instance->setPosition(position);
+            return instance;
+        }
+        if (auto plane = dynamic_cast<PlaneObject *>(prototype)) {
+            return makePrimitive<PlaneObject>(position, plane->getNormal(), material, &sceneManager);
+        }
+        if (auto polygon = dynamic_cast<PolygonObject *>(prototype)) {
+            std::span<const gm::IPoint3> cached = viewport3D->GetPolygonVertices(polygon);
+            std::vector<gm::IPoint3> vertices = (cached.empty() ? ExtractPolygonVertices(polygon)
+                                                                : std::vector<gm::IPoint3>(cached.begin(), cached.end()));
+            for (auto &vertex : vertices) vertex = moved(vertex);
+            auto instance = makePrimitive<PolygonObject>(vertices, material, &sceneManager);
+            viewport3D->SetPolygonVertices(instance, std::move(vertices));
+            return instance;
+        }
 
-        emittedProperty->SetLabel("Emitted");
-        emittedProperty->AddPropertyField(XLabel, XContent, setX);
-        emittedProperty->AddPropertyField(YLabel, YContent, setY);
-        emittedProperty->AddPropertyField(ZLabel, ZContent, setZ);
+        std::cerr << "makeInstance : unsupported primitive " << prototype->typeString() << "\n";
+        return nullptr;
     }
 
-    void fillSphereProperty(::SphereObject *selectedSphere, roa::Property *property) {
-        assert(selectedSphere);
-        assert(property);
+    void continueSceneSave() {
+        SceneSaveTask::State state = sceneSave->GetState();
+        if (state == SceneSaveTask::State::WRITING) return;
 
-        float radius = selectedSphere->getRadius();
+        auto onFinished = std::move(onSceneSaveFinished);
+        onSceneSaveFinished = nullptr;
+        sceneSave.reset();
+        if (onFinished) onFinished(state == SceneSaveTask::State::DONE);
+    }
 
-        std::string radiusLabel   = "Radius";
-        std::string radiusContent = std::to_string(radius);
+    void continueSceneConvert() {
+        SceneConvertTask::State state = sceneConvert->GetState();
+        if (state == SceneConvertTask::State::CONVERTING) return;
 
-        auto setRadius = [selectedSphere](const std::string &s){
-            setIfStringConvertedToFloat(s, [selectedSphere](float v){
-                selectedSphere->setRadius(v);
-            });
-        };
+        auto onFinished = std::move(onSceneConvertFinished);
+        onSceneConvertFinished = nullptr;
+        sceneConvert.reset();
+        if (onFinished) onFinished(state == SceneConvertTask::State::DONE);
+    }
+
+    // Primitives live in the viewport's arenas and are destroyed when their record is erased.
+    template <typename T, typename... Args>
+    T *makePrimitive(Args&&... args) { return viewport3D->GetPrimitiveStore().Make<T>(std::forward<Args>(args)...); }
 
-        property->SetLabel("Sphere properties");
-        property->AddPropertyField(radiusLabel, radiusContent, setRadius);
+    void layout() {
+        float borderPadding = 30;
+        float innerPadding = 3;
+    
+        float sumWidth = GetUI()->GetWindow()->GetSize().x - borderPadding * 2 - innerPadding;
+        float viewport3DWidth = sumWidth / 3 * 2;
+        float menuWidth = sumWidth - viewport3DWidth - borderPadding;
+        float viewport3DHeight = GetUI()->GetWindow()->GetSize().y - borderPadding * 2;
+        float menuHeight = (viewport3DHeight - innerPadding) / 2;
+
+        viewport3D->SetSize({viewport3DWidth, viewport3DHeight});
+        outliner->SetSize({menuWidth, menuHeight});
+        propertiesPanel->SetSize({menuWidth, menuHeight});
+
+        viewport3D->SetPos({borderPadding, borderPadding});
+        outliner->SetPos({viewport3D->GetPos().x + viewport3D->GetSize().x + innerPadding, viewport3D->GetPos().y});
+        propertiesPanel->SetPos(outliner->GetPos() + dr4::Vec2f(0, menuHeight + innerPadding));
     }
 
-    void fillCubeProperty(::CubeObject *selectedCube, roa::Property *property) {
-        assert(selectedCube);
-        assert(property);
+    // Position and visibility are per object, other fields are shared with the instance group.
+    void editField(::Primitives *object, SceneField field, float value) {
+        bool shared = (field != SceneField::VISIBILITY &&
+                       (field < SceneField::POSITION_X || field > SceneField::POSITION_Z));
+        std::vector<Primitives *> group = getInstanceGroup(object);
+        if (isMaterialField(field)) unshareMaterial(group);
+        if (shared) {
+            for (auto member : group) {
+                if (member == object) continue;
+                std::optional<AABB> before = viewport3D->GetBounds(member);
+                applySceneField(member, field, value);
+                journalSet(member, field, value);
+
+                std::optional<AABB> after = viewport3D->GetBounds(member);
+                std::optional<AABB> region = (before && after ? std::optional(before->United(*after)) : std::nullopt);
+                viewport3D->InvalidateObjectRegion(region);
+            }
+        }
 
-        std::string XLabel = "HalfSize X";
-        std::string YLabel = "                   Y";
-        std::string ZLabel = "                   Z";
+        applySceneField(object, field, value);
+        journalSet(object, field, value);
+        if (isMaterialField(field)) materials.FinishEdit(object->material());
+        objectEdited(object);
+    }
 
-        std::string XContent = std::to_string(selectedCube->getHalfSize().x());
-        std::string YContent = std::to_string(selectedCube->getHalfSize().y());
-        std::string ZContent = std::to_string(selectedCube->getHalfSize().z());
+    static bool isMaterialField(SceneField field) {
+        return field >= SceneField::DIFFUSE_X && field <= SceneField::EMITTED_Z;
+    }
 
-        auto setX = [selectedCube](const std::string &s){
-            setIfStringConvertedToFloat(s, [selectedCube](float v){
-                gm::IVec3f halfSize = selectedCube->getHalfSize();
-                halfSize.setX(v);
-                selectedCube->setHalfSize(halfSize);
-            });
-        };
-        auto setY = [selectedCube](const std::string &s){
-            setIfStringConvertedToFloat(s, [selectedCube](float v){
-                gm::IVec3f halfSize = selectedCube->getHalfSize();
-                halfSize.setY(v);
-                selectedCube->setHalfSize(halfSize);
-            });
-        };
-        auto setZ = [selectedCube](const std::string &s){
-            setIfStringConvertedToFloat(s, [selectedCube](float v){
-                gm::IVec3f halfSize = selectedCube->getHalfSize();
-                halfSize.setZ(v);
-                selectedCube->setHalfSize(halfSize);
-            });
-        };
+    // Copy-on-write: `owners` hold one material; if other objects hold it too,
+    // `owners` switch to a copy before it is edited.
+    void unshareMaterial(std::span<Primitives *const> owners) {
+        assert(!owners.empty());
+        RTMaterial *material = owners.front()->material();
+        RTMaterial *copy = materials.PrepareEdit(material, static_cast<uint32_t>(owners.size()));
+        if (copy == material) return;
+
+        for (auto owner : owners) {
+            assert(owner->material() == material);
+            if (const MeshInstance *mesh = viewport3D->GetMesh(owner)) {
+                for (auto triangle : mesh->triangles) triangle->setMaterial(copy);
+            } else {
+                owner->setMaterial(copy);
+            }
+        }
+    }
+
+    void journalSet(::Primitives *object, SceneField field, float value) {
+        auto it = journalIds.find(object);
+        if (it != journalIds.end() && !journalSuspended) journal.AppendSet(it->second, field, value);
+    }
 
-        property->SetLabel("Cube properties");
-        property->AddPropertyField(XLabel, XContent, setX);
-        property->AddPropertyField(YLabel, YContent, setY);
-        property->AddPropertyField(ZLabel, ZContent, setZ);
+    void compactJournalIfDue() {
+        size_t entries = journal.GetEntriesSinceCompaction();
+        if (entries == 0) return;
+        auto now = std::chrono::steady_clock::now();
+        auto due = lastJournalCompaction + JOURNAL_COMPACT_INTERVAL;
+        if (entries >= JOURNAL_COMPACT_ENTRIES || now >= due) {
+            compactJournal();
+            return;
+        }
+        // idle frames only come with input, the compaction must not wait for it
+        static_cast<UI*>(GetUI())->RequestFrameAfter(std::chrono::duration<double>(due - now).count());
     }
 
-    void fillPlaneProperty(::PlaneObject *seletedPlane, roa::Property *property) {
-        assert(seletedPlane);
-        assert(property);
+    void objectEdited(::Primitives *object) {
+        assert(object);
+        viewport3D->InvalidateObject(object);
+
+        std::optional<AABB> newBounds = viewport3D->GetBounds(object);
+        std::optional<AABB> editedRegion = std::nullopt;
+        if (selectedBounds && newBounds) editedRegion = selectedBounds->United(*newBounds);
+        viewport3D->InvalidateObjectRegion(editedRegion);
+        selectedBounds = newBounds;
+    }
+
+    // Shows the property groups of the selected object. The groups are pooled in the
+    // properties panel, a selection change only rebinds them and refreshes their values.
+    void updateRecords() {
+        auto selectedObject = outliner->GetSelected();
+        propertiesObject = (selectedObject.has_value() ? selectedObject->second : nullptr);
+        selectedBounds = propertiesObject ? viewport3D->GetBounds(propertiesObject) : std::nullopt;
+
+        shownPropertyGroups.clear();
+        auto show = [this](PropertyGroup group) { shownPropertyGroups.push_back(static_cast<size_t>(group)); };
+
+        // mesh triangles share one material, the handle's transform and visibility are its own
+        if (propertiesObject && viewport3D->GetMesh(propertiesObject)) {
+            show(PropertyGroup::DIFFUSE);
+            show(PropertyGroup::SPECULAR);
+            show(PropertyGroup::EMITTED);
+        } else if (propertiesObject) {
+            show(PropertyGroup::TRANSFORM);
+            show(PropertyGroup::DIFFUSE);
+            show(PropertyGroup::SPECULAR);
+            show(PropertyGroup::EMITTED);
+            if (auto special = specialPropertyGroup(propertiesObject)) show(*special);
+            show(PropertyGroup::VISIBILITY);
+        }
+
+        for (size_t group : shownPropertyGroups) bindProperty(static_cast<PropertyGroup>(group));
+        propertiesPanel->ShowProperties(shownPropertyGroups);
 
-        std::string XLabel = "Normal X";
-        std::string YLabel = "               Y";
-        std::string ZLabel = "               Z";
+        RequestRedraw(*this);
+    }
 
-        std::string XContent = std::to_string(seletedPlane->getNormal().x());
-        std::string YContent = std::to_string(seletedPlane->getNormal().y());
-        std::string ZContent = std::to_string(seletedPlane->getNormal().z());
+    static std::optional<PropertyGroup> specialPropertyGroup(::Primitives *object) {
+        if (dynamic_cast<::SphereObject *>(object)) return PropertyGroup::SPHERE;
+        if (dynamic_cast<::PlaneObject *>(object))  return PropertyGroup::PLANE;
+        if (dynamic_cast<::CubeObject *>(object))   return PropertyGroup::CUBE;
+        return std::nullopt;
+    }
 
-        auto setX = [seletedPlane](const std::string &s){
-            setIfStringConvertedToFloat(s, [seletedPlane](float v){
-                gm::IVec3f normal = seletedPlane->getNormal();
-                normal.setX(v);
-                seletedPlane->setNormal(normal);
+    // Pooled property of `group`, its fields are added on first use. Field actions edit
+    // whatever object the properties are bound to when Enter is pressed or a value is
+    // scrubbed; the viewport previews scrubbed values and converges once it is released.
+    roa::Property &pooledProperty(PropertyGroup group) {
+        roa::Property &property = propertiesPanel->GetPooledProperty(static_cast<size_t>(group));
+        if (property.GetFieldCount() != 0) return property;
+
+        auto addField = [this, &property](const std::string &label, SceneField field) {
+            property.AddPropertyField(label, "", [this, field](const std::string &s){
+                setIfStringConvertedToFloat(s, [this, field](float v){
+                    if (propertiesObject) editField(propertiesObject, field, v);
+                });
+            }, [this, field](float v, bool final){
+                if (!final) viewport3D->SetPreviewMode(true);
+                if (propertiesObject) editField(propertiesObject, field, v);
+                if (final) viewport3D->SetPreviewMode(false); // last, its full re-trace supersedes the region one
             });
         };
-        auto setY = [seletedPlane](const std::string &s){
-            setIfStringConvertedToFloat(s, [seletedPlane](float v){
-                gm::IVec3f normal = seletedPlane->getNormal();
-                normal.setY(v);
-                seletedPlane->setNormal(normal);
-            });
+        auto addVectorFields = [&addField](const std::string &xLabel, const std::string &indent, SceneField xField) {
+            addField(xLabel, xField);
+            addField(indent + "Y", static_cast<SceneField>(static_cast<uint8_t>(xField) + 1));
+            addField(indent + "Z", static_cast<SceneField>(static_cast<uint8_t>(xField) + 2));
         };
-        auto setZ = [seletedPlane](const std::string &s){
-            setIfStringConvertedToFloat(s, [seletedPlane](float v){
-                gm::IVec3f normal = seletedPlane->getNormal();
-                normal.setZ(v);
-                seletedPlane->setNormal(normal);
+
+        switch (group) {
+        case PropertyGroup::TRANSFORM:
+            property.SetLabel("Transform");
+            addVectorFields("Location X", "                 ", SceneField::POSITION_X);
+            break;
+        case PropertyGroup::DIFFUSE:
+            property.SetLabel("Diffuse");
+            addVectorFields("Diffuse X", "              ", SceneField::DIFFUSE_X);
+            break;
+        case PropertyGroup::SPECULAR:
+            property.SetLabel("Specular");
+            addVectorFields("Specular X", "                 ", SceneField::SPECULAR_X);
+            break;
+        case PropertyGroup::EMITTED:
+            property.SetLabel("Emitted");
+            addVectorFields("Emitted X", "              ", SceneField::EMITTED_X);
+            break;
+        case PropertyGroup::SPHERE:
+            property.SetLabel("Sphere properties");
+            addField("Radius", SceneField::RADIUS);
+            break;
+        case PropertyGroup::PLANE:
+            property.SetLabel("Plane properties");
+            addVectorFields("Normal X", "               ", SceneField::NORMAL_X);
+            break;
+        case PropertyGroup::CUBE:
+            property.SetLabel("Cube properties");
+            addVectorFields("HalfSize X", "                   ", SceneField::HALF_SIZE_X);
+            break;
+        case PropertyGroup::VISIBILITY:
+            property.SetLabel("Visibility");
+            // shows or hides the object; the per-ray-kind bits of a loaded mask are kept for scene files
+            property.AddPropertyField("Visible", "", [this](const std::string &s){
+                setIfStringConvertedToFloat(s, [this](float v){
+                    if (!propertiesObject) return;
+                    uint8_t mask = viewport3D->GetVisibility(propertiesObject);
+                    if (v == 0) mask = 0;
+                    else if (mask == 0) mask = RAY_VISIBILITY_ALL;
+                    editField(propertiesObject, SceneField::VISIBILITY, mask);
+                });
             });
+            break;
+        default: assert(0); break;
+        }
+        return property;
+    }
+
+    // Refreshes the values of `group` from propertiesObject. Values are formatted into a
+    // local buffer, fields whose text did not change allocate nothing.
+    void bindProperty(PropertyGroup group) {
+        assert(propertiesObject);
+        roa::Property &property = pooledProperty(group);
+
+        char buffer[64];
+        auto format = [&buffer](float value) {
+            auto [ptr, ec] = std::to_chars(buffer, buffer + sizeof(buffer), value, std::chars_format::fixed, 6);
+            return std::string_view(buffer, (ec == std::errc() ? ptr : buffer));
+        };
+        auto setVector = [&property, &format](const auto &v) {
+            property.SetFieldContent(0, format(v.x()));
+            property.SetFieldContent(1, format(v.y()));
+            property.SetFieldContent(2, format(v.z()));
         };
 
-        property->SetLabel("Plane properties");
-        property->AddPropertyField(XLabel, XContent, setX);
-        property->AddPropertyField(YLabel, YContent, setY);
-        property->AddPropertyField(ZLabel, ZContent, setZ);
+        switch (group) {
+        case PropertyGroup::TRANSFORM: setVector(propertiesObject->position()); break;
+        case PropertyGroup::DIFFUSE:   setVector(propertiesObject->material()->diffuse()); break;
+        case PropertyGroup::SPECULAR:  setVector(propertiesObject->material()->specular()); break;
+        case PropertyGroup::EMITTED:   setVector(propertiesObject->material()->emitted()); break;
+        case PropertyGroup::SPHERE:
+            property.SetFieldContent(0, format(dynamic_cast<::SphereObject *>(propertiesObject)->getRadius()));
+            break;
+        case PropertyGroup::PLANE: setVector(dynamic_cast<::PlaneObject *>(propertiesObject)->getNormal()); break;
+        case PropertyGroup::CUBE:  setVector(dynamic_cast<::CubeObject *>(propertiesObject)->getHalfSize()); break;
+        case PropertyGroup::VISIBILITY:
+            property.SetFieldContent(0, viewport3D->GetVisibility(propertiesObject) != 0 ? "1" : "0");
+            break;
+        default: assert(0); break;
+        }
     }
 };
 
 } // namespace roa
+
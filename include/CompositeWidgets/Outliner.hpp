@@ -1,4 +1,12 @@
 #pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <span>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
 #include "BasicWidgets/Buttons.hpp"
 #include "BasicWidgets/TextWidgets.hpp"
 #include "BasicWidgets/Window.hpp"
@@ -33,6 +41,7 @@ class ObjectButton final : public Button {
     dr4::Vec2f iconSize = {16, 16};
     std::unique_ptr<dr4::Text> label;
     std::unique_ptr<dr4::Image> mainIcon;
+    std::string mainIconPath;
 
     bool isRenaming = false;
     std::unique_ptr<TextInputWidget> renameInput;
@@ -60,31 +69,42 @@ public:
 
     void SetIconSize(const dr4::Vec2f size) {
         iconSize = size;
+        mainIconPath.clear();
         layout();
     }
 
+    // Shows the pressed state of the record it is rebound to, without running press actions.
+    void ShowPressed(bool newPressed) {
+        if (pressed == newPressed) return;
+        pressed = newPressed;
+        RequestRedraw(*this);
+    }
+
     void SetOnDeleteAction(std::function<void()> action) { onDeleteAction = action; }
     void SetOnRenameAction(std::function<void(const std::string&)> action) { onRenameAction = action; }
 
     void SetLabel(const std::string& text) {
         label->SetText(text);
-        ForceRedraw();
+        RequestRedraw(*this);
     }
 
     void SetLabelFontSize(int fontSize) {
         label->SetFontSize(fontSize);
-        ForceRedraw();
+        RequestRedraw(*this);
     }
 
+    // Recycled records are rebound often, an unchanged icon is not rasterized again.
     void LoadSVGMainIcon(const std::string& path) {
+        if (path == mainIconPath) return;
+        mainIconPath = path;
         ExtractSVG(path, mainIcon->GetSize(),
             [this](int x, int y, dr4::Color c){ mainIcon->SetPixel(x, y, c); });
-        ForceRedraw();
+        RequestRedraw(*this);
     }
 
     void SetColorPack(const ObjectButtonColorPack pack) {
         colorPack = pack;
-        ForceRedraw();
+        RequestRedraw(*this);
     }
 
     std::string GetLabel() const { return label->GetText(); }
@@ -107,7 +127,7 @@ public:
         renameInput->SetOnEnterAction([this](const std::string&) { FinishRenaming(true); });
 
         renameRequested = true;
-        ForceRedraw();
+        RequestRedraw(*this);
     }
 
     void FinishRenaming(bool apply) {
@@ -127,11 +147,12 @@ public:
         renameRequested = false;
 
         GetUI()->ReportFocus(this);
-        ForceRedraw();
+        RequestRedraw(*this);
     }
 
 protected:
     void Redraw() const override {
+        if (!beginLayerRedraw(*this)) return;
         GetTexture().Clear(FULL_TRANSPARENT);
 
         if (isRenaming && renameInput) {
@@ -169,7 +190,7 @@ protected:
             }
 
             auto result = event.Apply(*renameInput);
-            if (result == hui::EventResult::HANDLED) ForceRedraw();
+            if (result == hui::EventResult::HANDLED) RequestRedraw(*this);
             return result;
         }
 
@@ -191,7 +212,7 @@ protected:
     hui::EventResult OnText(hui::TextEvent &event) override {
         if (isRenaming && renameInput) {
             auto result = event.Apply(*renameInput);
-            if (result == hui::EventResult::HANDLED) ForceRedraw();
+            if (result == hui::EventResult::HANDLED) RequestRedraw(*this);
             return result;
         }
         return hui::EventResult::UNHANDLED;
@@ -206,7 +227,7 @@ protected:
             auto adjusted = event;
             adjusted.pos -= renameInput->GetPos();
             auto result = adjusted.Apply(*renameInput);
-            if (result == hui::EventResult::HANDLED) ForceRedraw();
+            if (result == hui::EventResult::HANDLED) RequestRedraw(*this);
             return result;
         }
         return Button::OnMouseDown(event);
@@ -217,7 +238,7 @@ protected:
             auto adjusted = event;
             adjusted.pos -= renameInput->GetPos();
             auto result = adjusted.Apply(*renameInput);
-            if (result == hui::EventResult::HANDLED) ForceRedraw();
+            if (result == hui::EventResult::HANDLED) RequestRedraw(*this);
             return result;
         }
         return Button::OnMouseUp(event);
@@ -240,9 +261,10 @@ protected:
             static double acc = 0;
             acc += event.deltaTime;
             if (acc > 0.05) {
-                ForceRedraw();
+                RequestRedraw(*this);
                 acc = 0;
             }
+            static_cast<UI*>(GetUI())->RequestFrameAfter(0.05);
             return result;
         }
         return Button::OnIdle(event);
@@ -277,13 +299,17 @@ private:
             label->SetFontSize(14);
 
         label->SetColor(dr4::Color(174,174,174,255));
-        ForceRedraw();
+        RequestRedraw(*this);
     }
 };
 
+// Shows any number of records with only as many ObjectButtons as fit in its area.
+// Records are kept as plain rows; on scroll the buttons are rebound to other rows
+// instead of being moved, so widget memory and scroll cost do not depend on the row count.
 template <IsPointer T>
 class Outliner final : public RecordsPanel<ObjectButton> {
     static constexpr float RECORD_HEIGHT = 20.0f;
+    static constexpr size_t NO_ROW = SIZE_MAX;
 
     dr4::Vec2f recordIconStartPos = {20, 3};
     dr4::Vec2f recordIconSize = {16, 16};
@@ -294,6 +320,30 @@ class Outliner final : public RecordsPanel<ObjectButton> {
     std::function<void(T)> onDeleteAction = nullptr;
     Button::Mode recordButtonMode = Button::Mode::STICK_MODE;
 
+public:
+    struct RecordInfo {
+        T                     object = nullptr;
+        std::string           name;
+        std::function<void()> onSelect = nullptr;
+        std::function<void()> onUnSelect = nullptr;
+        std::string           iconPath = "";
+    };
+
+private:
+    struct Row {
+        T                     object = nullptr;
+        std::string           name;
+        std::function<void()> onSelect = nullptr;
+        std::function<void()> onUnSelect = nullptr;
+        uint32_t              icon = 0;       // index in iconPaths
+        bool                  pressed = false;
+    };
+
+    std::vector<Row>              rows;
+    std::vector<std::string>      iconPaths;   // few distinct paths, shared by all rows
+    std::unordered_map<T, size_t> rowByObject;
+    std::vector<size_t>           boundRows;   // row shown by records[i], NO_ROW if none yet
+
 public:
     Outliner(hui::UI* ui) : RecordsPanel<ObjectButton>(ui) {}
 
@@ -306,79 +356,85 @@ public:
                    std::function<void()> onUnSelect,
                    const std::string& iconPath = "")
     {
-        auto record = std::make_unique<ObjectButton>(GetUI());
-        record->SetLabel(name);
-        record->SetLabelFontSize(recordLabelFontSize);
-        record->SetMode(recordButtonMode);
-        record->SetIconSize(recordIconSize);
-        record->SetIconStartPos(recordIconStartPos);
-        record->SetSize(GetSize().x, RECORD_HEIGHT);
-
-        if (iconPath.empty())
-            record->LoadSVGMainIcon(static_cast<UI*>(GetUI())->GetTexturePack().outlinerObMeshSvgPath);
-        else
-            record->LoadSVGMainIcon(iconPath);
-
-        record->SetOnPressAction([this, name, object, onSelect, onUnSelect]{
-            if (onSelect) onSelect();
-            if (!currentSelected || currentSelected->second != object) {
-                currentSelected = {name, object};
-                if (onSelectChangedAction) onSelectChangedAction();
-            }
-        });
-
-        record->SetOnUnpressAction([this, object, onUnSelect]{
-            if (onUnSelect) onUnSelect();
-            if (currentSelected && currentSelected->second == object) {
-                currentSelected.reset();
-                if (onSelectChangedAction) onSelectChangedAction();
-            }
-        });
-
-        ObjectButton* recordPtr = record.get();
-        record->SetOnDeleteAction([this, object, recordPtr]{
-            if (onDeleteAction) onDeleteAction(object);
-            if (currentSelected && currentSelected->second == object) {
-                currentSelected.reset();
-                if (onSelectChangedAction) onSelectChangedAction();
-            }
-            ClearRecord(recordPtr);
-        });
-
-        if (GetRecordCount() % 2) record->SetColorPack(GRAY_OBJECT_PACK);
-        else record->SetColorPack(BLACK_OBJECT_PACK);
+        addRow({object, name, onSelect, onUnSelect, iconPath});
+        relayout();
+    }
 
-        RecordsPanel<ObjectButton>::AddRecord(std::move(record));
+    void AddRecords(std::span<const RecordInfo> infos) {
+        rows.reserve(rows.size() + infos.size());
+        for (const auto &info : infos) addRow(info);
+        relayout();
     }
 
+    size_t GetRecordCount() const { return rows.size(); }
+
     void ClearRecords() {
         currentSelected.reset();
+        rows.clear();
+        rowByObject.clear();
+        boundRows.clear();
         if (onSelectChangedAction) onSelectChangedAction();
         RecordsPanel::ClearRecords();
     }
 
+    // Removes the record of `object` without calling the delete action.
+    void EraseRecord(T object) {
+        auto it = rowByObject.find(object);
+        if (it == rowByObject.end()) return;
+        eraseRow(it->second);
+    }
+
+    // EraseRecord for many objects, the remaining rows are reindexed once for the whole batch.
+    void EraseRecords(std::span<const T> objects) {
+        std::vector<bool> erased(rows.size(), false);
+        bool any = false;
+        for (T object : objects) {
+            auto it = rowByObject.find(object);
+            if (it == rowByObject.end()) continue;
+            erased[it->second] = true;
+            any = true;
+        }
+        if (any) eraseRows(erased);
+    }
+
+    // Selects the record of `object` as if it was clicked; nullptr clears selection.
+    void SelectRecord(T object) {
+        if (currentSelected && currentSelected->second == object) return;
+
+        if (currentSelected) {
+            auto it = rowByObject.find(currentSelected->second);
+            if (it != rowByObject.end()) setRowPressed(it->second, false);
+        }
+        if (!object) return;
+
+        auto it = rowByObject.find(object);
+        if (it != rowByObject.end()) setRowPressed(it->second, true);
+    }
+
     void SetRecordButtonMode(Button::Mode mode) {
         recordButtonMode = mode;
         for (auto r : records) r->SetMode(mode);
-        ForceRedraw();
+        RequestRedraw(*this);
     }
 
     void SetRecordIconStartPos(const dr4::Vec2f pos) {
         recordIconStartPos = pos;
         for (auto r : records) r->SetIconStartPos(pos);
-        ForceRedraw();
+        RequestRedraw(*this);
     }
 
     void SetRecordLabelFontSize(int fontSize) {
         recordLabelFontSize = fontSize;
         for (auto r : records) r->SetLabelFontSize(fontSize);
-        ForceRedraw();
+        RequestRedraw(*this);
     }
 
+    // Icons are rasterized at the new size when the records are rebound.
     void SetRecordIconSize(const dr4::Vec2f size) {
         recordIconSize = size;
         for (auto r : records) r->SetIconSize(size);
-        ForceRedraw();
+        unbindRecords();
+        relayout();
     }
 
     std::optional<std::pair<std::string, T>> GetSelected() { return currentSelected; }
@@ -392,6 +448,183 @@ protected:
             r->SetSize(GetSize().x, RECORD_HEIGHT);
         RecordsPanel<ObjectButton>::relayout();
     }
+
+    float calculateContentHeight() const override { return rows.size() * (RECORD_HEIGHT + recordsPadding); }
+
+    // Only the rows in view get a button. Scrolling within a row just moves the buttons,
+    // the panel recomposites them from their retained textures.
+    void relayoutRecords() override {
+        float step = RECORD_HEIGHT + recordsPadding;
+        size_t visibleCount = static_cast<size_t>(std::ceil(GetSize().y / step)) + 1;
+        resizePool(std::min(rows.size(), visibleCount));
+
+        float scrollOffset = calculateScrollOffset();
+        size_t firstRow = std::min(static_cast<size_t>(scrollOffset / step), rows.size() - records.size());
+
+        for (size_t slot = 0; slot < records.size(); slot++) {
+            size_t row = firstRow + slot;
+            bindRecord(slot, row);
+            records[slot]->SetPos(recordsStartPos + dr4::Vec2f(0, row * step - scrollOffset));
+        }
+        RequestRedraw(*this);
+    }
+
+private:
+    void addRow(const RecordInfo &info) {
+        const std::string &iconPath = (info.iconPath.empty()
+            ? static_cast<UI*>(GetUI())->GetTexturePack().outlinerObMeshSvgPath
+            : info.iconPath);
+
+        auto icon = std::find(iconPaths.begin(), iconPaths.end(), iconPath);
+        if (icon == iconPaths.end()) icon = iconPaths.insert(iconPaths.end(), iconPath);
+
+        if (info.object) rowByObject[info.object] = rows.size();
+        rows.push_back({info.object, info.name, info.onSelect, info.onUnSelect,
+                        static_cast<uint32_t>(icon - iconPaths.begin())});
+    }
+
+    void eraseRow(size_t row) {
+        assert(row < rows.size());
+        std::vector<bool> erased(rows.size(), false);
+        erased[row] = true;
+        eraseRows(erased);
+    }
+
+    // Keeps the order of the remaining rows, each of them is moved and reindexed at most once.
+    void eraseRows(const std::vector<bool> &erased) {
+        assert(erased.size() == rows.size());
+        unbindRecords();
+
+        bool selectionErased = false;
+        size_t kept = 0;
+        for (size_t row = 0; row < rows.size(); row++) {
+            if (erased[row]) {
+                if (rows[row].object) rowByObject.erase(rows[row].object);
+                if (currentSelected && currentSelected->second == rows[row].object) selectionErased = true;
+                continue;
+            }
+            if (kept != row) {
+                rows[kept] = std::move(rows[row]);
+                if (rows[kept].object) rowByObject[rows[kept].object] = kept;
+            }
+            kept++;
+        }
+        rows.erase(rows.begin() + kept, rows.end());
+
+        if (selectionErased) {
+            currentSelected.reset();
+            if (onSelectChangedAction) onSelectChangedAction();
+        }
+        relayout();
+    }
+
+    // Actions run when a row gets (un)pressed, whether by its button or by SelectRecord.
+    void pressRow(size_t row) {
+        assert(row < rows.size());
+        rows[row].pressed = true;
+        // the action may add rows, so nothing is kept by reference across it
+        auto [object, name, onSelect] = std::tuple(rows[row].object, rows[row].name, rows[row].onSelect);
+        if (onSelect) onSelect();
+        if (!currentSelected || currentSelected->second != object) {
+            currentSelected = {name, object};
+            if (onSelectChangedAction) onSelectChangedAction();
+        }
+    }
+
+    void unpressRow(size_t row) {
+        assert(row < rows.size());
+        rows[row].pressed = false;
+        auto [object, onUnSelect] = std::tuple(rows[row].object, rows[row].onUnSelect);
+        if (onUnSelect) onUnSelect();
+        if (currentSelected && currentSelected->second == object) {
+            currentSelected.reset();
+            if (onSelectChangedAction) onSelectChangedAction();
+        }
+    }
+
+    void setRowPressed(size_t row, bool pressed) {
+        if (rows[row].pressed == pressed) return;
+
+        auto slot = std::find(boundRows.begin(), boundRows.end(), row);
+        if (slot != boundRows.end()) records[slot - boundRows.begin()]->ShowPressed(pressed);
+
+        if (pressed) pressRow(row);
+        else unpressRow(row);
+    }
+
+    void deleteRow(size_t row) {
+        T object = rows[row].object;
+        size_t rowCount = rows.size();
+
+        if (onDeleteAction) onDeleteAction(object);
+
+        // the action usually erases the record itself
+        if (object) EraseRecord(object);
+        else if (rows.size() == rowCount) eraseRow(row);
+    }
+
+    void renameRow(size_t row, const std::string &name) {
+        assert(row < rows.size());
+        rows[row].name = name;
+        if (currentSelected && currentSelected->second == rows[row].object) currentSelected->first = name;
+    }
+
+    void bindRecord(size_t slot, size_t row) {
+        if (boundRows[slot] == row) return;
+
+        ObjectButton *record = records[slot];
+        if (record->IsRenaming()) record->FinishRenaming(true);
+        boundRows[slot] = row;
+
+        const Row &info = rows[row];
+        record->SetLabel(info.name);
+        record->LoadSVGMainIcon(iconPaths[info.icon]);
+        record->ShowPressed(info.pressed);
+        record->SetColorPack(row % 2 ? GRAY_OBJECT_PACK : BLACK_OBJECT_PACK);
+    }
+
+    // Row indices shift on erase, every button gets bound again on the next relayout.
+    // A rename in progress is applied to its row first.
+    void unbindRecords() {
+        for (auto r : records) {
+            if (r->IsRenaming()) r->FinishRenaming(true);
+        }
+        std::fill(boundRows.begin(), boundRows.end(), NO_ROW);
+    }
+
+    void resizePool(size_t size) {
+        while (records.size() < size) {
+            auto record = makeRecord(records.size());
+            records.push_back(record.get());
+            boundRows.push_back(NO_ROW);
+            AddWidget(std::move(record));
+        }
+        while (records.size() > size) {
+            ObjectButton *record = records.back();
+            if (record->IsRenaming()) record->FinishRenaming(true);
+            records.pop_back();
+            boundRows.pop_back();
+            // destroyed on idle, so a record may trigger its own removal
+            Container::EraseWidget(record);
+        }
+    }
+
+    // The actions look up the row the record is bound to when they run.
+    std::unique_ptr<ObjectButton> makeRecord(size_t slot) {
+        auto record = std::make_unique<ObjectButton>(GetUI());
+        record->SetLabelFontSize(recordLabelFontSize);
+        record->SetMode(recordButtonMode);
+        record->SetIconSize(recordIconSize);
+        record->SetIconStartPos(recordIconStartPos);
+        record->SetSize(GetSize().x, RECORD_HEIGHT);
+
+        record->SetOnPressAction([this, slot]{ pressRow(boundRows[slot]); });
+        record->SetOnUnpressAction([this, slot]{ unpressRow(boundRows[slot]); });
+        record->SetOnDeleteAction([this, slot]{ deleteRow(boundRows[slot]); });
+        record->SetOnRenameAction([this, slot](const std::string &name){ renameRow(boundRows[slot], name); });
+
+        return record;
+    }
 };
 
 template <IsPointer T>
@@ -412,9 +645,13 @@ public:
     {
         outliner->AddRecord(object, name, onSelect, onUnSelect, iconPath);
     }
+    void AddRecords(std::span<const typename Outliner<T>::RecordInfo> infos) { outliner->AddRecords(infos); }
 
     void SetOnDeleteAction(std::function<void(T)> action) { outliner->SetOnDeleteAction(action); }
     void ClearRecords() { outliner->ClearRecords(); }
+    void EraseRecord(T object) { outliner->EraseRecord(object); }
+    void EraseRecords(std::span<const T> objects) { outliner->EraseRecords(objects); }
+    void SelectRecord(T object) { outliner->SelectRecord(object); }
 
     std::optional<std::pair<std::string, T>> GetSelected() { return outliner->GetSelected(); }
     void SetOnSelectChangedAction(std::function<void()> action) { outliner->SetOnSelectChangedAction(action); }
@@ -1,4 +1,11 @@
 #pragma once
+#include <algorithm>
+#include <cstdlib>
+#include <functional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
 
 #include "CompositeWidgets/RecordsPanel.hpp"
 #include "CompositeWidgets/DropDownMenu.hpp"
@@ -7,11 +14,23 @@
 namespace roa {
 
 // ---------------- PropertyField ----------------
+// Numeric fields with a scrub action can also be dragged on their label. Mouse moves
+// only accumulate the distance; the value is applied on idle, so the action runs at
+// most once per frame with `final` false, and once more with `final` true on release.
 class PropertyField final : public Container {
+    static constexpr float SCRUB_UNITS_PER_PIXEL = 0.01f;
+
     std::unique_ptr<dr4::Text> label;
     TextInputWidget* inputField = nullptr;
     dr4::Color BGColor = FULL_TRANSPARENT;
 
+    std::function<void(float, bool)> onScrubAction = nullptr;
+    bool  scrubbing     = false;
+    bool  scrubPending  = false; // moved since the value was last applied
+    bool  scrubApplied  = false; // the action ran during this drag
+    float scrubStart    = 0;
+    float scrubDistance = 0;
+
 public:
     explicit PropertyField(hui::UI* ui): 
         Container(ui),
@@ -31,37 +50,97 @@ public:
 
     void SetLabel(const std::string& content) {
         label->SetText(content);
-        ForceRedraw();
+        RequestRedraw(*this);
     }
 
-    void SetContent(const std::string& content) {
-        inputField->SetText(content);
-        ForceRedraw();
+    // Only a changed value allocates.
+    void SetContent(std::string_view content) {
+        if (inputField->HasText(content)) return;
+        inputField->SetText(std::string(content));
+        RequestRedraw(*this);
     }
 
     void SetBGColor(dr4::Color color) {
         BGColor = color;
         inputField->SetBGColor(BGColor);
-        ForceRedraw();
+        RequestRedraw(*this);
     }
 
     void SetOnEnterAction(std::function<void(const std::string&)> action) {
         inputField->SetOnEnterAction(action);
     }
 
+    void SetOnScrubAction(std::function<void(float value, bool final)> action) {
+        onScrubAction = action;
+    }
+
 protected:
     void OnSizeChanged() override { relayout(); }
 
+    hui::EventResult OnMouseDown(hui::MouseButtonEvent &event) override {
+        if (!onScrubAction || !GetRect().Contains(event.pos) || event.button != dr4::MouseButtonType::LEFT ||
+            event.pos.x - GetPos().x >= inputField->GetPos().x) {
+            return Container::OnMouseDown(event);
+        }
+
+        char* end = nullptr;
+        std::string text = inputField->GetText();
+        float value = std::strtof(text.c_str(), &end);
+        if (end == text.c_str() || *end != '\0') return Container::OnMouseDown(event);
+
+        scrubbing = true;
+        scrubPending = scrubApplied = false;
+        scrubStart = value;
+        scrubDistance = 0;
+        GetUI()->ReportFocus(this);
+        GetUI()->SetCaptured(this);
+        return hui::EventResult::HANDLED;
+    }
+
+    hui::EventResult OnMouseMove(hui::MouseMoveEvent &event) override {
+        if (!scrubbing) return Container::OnMouseMove(event);
+
+        if (event.rel.x != 0) {
+            scrubDistance += event.rel.x;
+            scrubPending = true;
+        }
+        return hui::EventResult::HANDLED;
+    }
+
+    hui::EventResult OnMouseUp(hui::MouseButtonEvent &event) override {
+        if (!scrubbing || event.button != dr4::MouseButtonType::LEFT) return Container::OnMouseUp(event);
+
+        scrubbing = false;
+        GetUI()->SetCaptured(nullptr);
+        if (scrubPending || scrubApplied) applyScrub(true);
+        return hui::EventResult::HANDLED;
+    }
+
+    hui::EventResult OnIdle(hui::IdleEvent &event) override {
+        if (scrubbing && scrubPending) applyScrub(false);
+        return Container::OnIdle(event);
+    }
+
+    void applyScrub(bool final) {
+        float value = scrubStart + scrubDistance * SCRUB_UNITS_PER_PIXEL;
+        scrubPending = false;
+        scrubApplied = true;
+        SetContent(std::to_string(value));
+        onScrubAction(value, final);
+        static_cast<UI*>(GetUI())->RequestFrame();
+    }
+
     void relayout() {
         float halfWidth = GetSize().x / 2.0f;
         inputField->SetSize({halfWidth, GetSize().y});
         inputField->SetPos({halfWidth, 0});
         inputField->SetBGColor(BGColor);
-        inputField->ForceRedraw();
-        ForceRedraw();
+        RequestRedraw(*inputField);
+        RequestRedraw(*this);
     }
 
     void Redraw() const override {
+        if (!beginLayerRedraw(*this)) return;
         GetTexture().Clear(BGColor);
         label->DrawOn(GetTexture());
         inputField->DrawOn(GetTexture());
@@ -76,6 +155,7 @@ class Property final : public DropDownMenu {
     const dr4::Vec2f recordsStartPos = {16, 0};
 
     RecordsPanel<PropertyField>* fieldsPanel = nullptr;
+    std::vector<PropertyField*> fields;
 
 public:
     explicit Property(hui::UI* ui) : DropDownMenu(ui)
@@ -95,8 +175,10 @@ public:
 
     virtual ~Property() = default;
 
+    // `onScrubAction` makes the field draggable, see PropertyField.
     void AddPropertyField(const std::string& label, const std::string& value,
-                          std::function<void(const std::string&)> onEnterAction)
+                          std::function<void(const std::string&)> onEnterAction,
+                          std::function<void(float, bool)> onScrubAction = nullptr)
     {
         auto field = std::make_unique<PropertyField>(GetUI());
         field->SetSize(GetSize().x - 2 * recordsStartPos.x, 25);
@@ -104,10 +186,20 @@ public:
         field->SetContent(value);
         field->SetBGColor(BGColor);
         field->SetOnEnterAction(onEnterAction);
+        field->SetOnScrubAction(onScrubAction);
 
+        fields.push_back(field.get());
         fieldsPanel->AddRecord(std::move(field));
     }
 
+    size_t GetFieldCount() const { return fields.size(); }
+
+    // Rebinding a pooled property only changes its values.
+    void SetFieldContent(size_t index, std::string_view value) {
+        assert(index < fields.size());
+        fields[index]->SetContent(value);
+    }
+
 protected:
     void OnSizeChanged() override {
         DropDownMenu::OnSizeChanged();
@@ -120,14 +212,21 @@ private:
         fieldsPanel->SetSize(GetSize().x, height);
 
         fieldsPanel->SetAllRecordsSize({GetSize().x - 2 * recordsStartPos.x, 25});
-        ForceRedraw();
+        RequestRedraw(*this);
     }
 };
 
 // ---------------- PropertiesPanel ----------------
+// Properties are pooled by key: each key gets one Property, built on first use, and
+// ShowProperties attaches the listed ones. Hidden properties are detached and kept with
+// their fields, so changing the selection rebinds widgets instead of rebuilding them.
 class PropertiesPanel final : public RecordsPanel<DropDownMenu> {
     const dr4::Vec2f RECORDS_START_POS = {8,16};
 
+    std::vector<Property*>                 pooled;   // by key, shown or not
+    std::vector<std::unique_ptr<Property>> detached; // by key, owned here while not shown
+    std::vector<size_t>                    shownKeys;
+
 public:
     explicit PropertiesPanel(hui::UI* ui) : RecordsPanel(ui) {
         SetRecordsPadding(2);
@@ -137,11 +236,42 @@ public:
 
     virtual ~PropertiesPanel() = default;
 
-    void AddProperty(std::unique_ptr<Property> property) {
-        property->SetOnSizeChangedAction([this](){ relayout(); });
-        property->SetSize(GetSize().x - 2 * RECORDS_START_POS.x, 25);
-        AddRecord(std::move(property));
+    Property &GetPooledProperty(size_t key) {
+        if (key >= pooled.size()) {
+            pooled.resize(key + 1, nullptr);
+            detached.resize(key + 1);
+        }
+        if (!pooled[key]) {
+            detached[key] = std::make_unique<Property>(GetUI());
+            detached[key]->SetOnSizeChangedAction([this](){ relayout(); });
+            detached[key]->SetSize(GetSize().x - 2 * RECORDS_START_POS.x, 25);
+            pooled[key] = detached[key].get();
+        }
+        return *pooled[key];
     }
+
+    // Shows the pooled properties of `keys` in that order. A property keeps its size,
+    // so an expanded one stays expanded across selections.
+    void ShowProperties(std::span<const size_t> keys) {
+        if (std::ranges::equal(keys, shownKeys)) return;
+
+        for (size_t key : shownKeys) {
+            detached[key].reset(static_cast<Property*>(ReleaseWidget(pooled[key]).release()));
+        }
+        records.clear();
+
+        shownKeys.assign(keys.begin(), keys.end());
+        for (size_t key : shownKeys) {
+            assert(key < pooled.size() && detached[key]);
+            Property *property = detached[key].get();
+            property->SetSize(GetSize().x - 2 * RECORDS_START_POS.x, property->GetSize().y);
+            records.push_back(property);
+            AddWidget(std::move(detached[key]));
+        }
+        relayout();
+    }
+
+    void ClearRecords() { ShowProperties({}); }
 };
 
 // ---------------- PropertiesWindow ----------------
@@ -159,7 +289,8 @@ public:
 
     virtual ~PropertiesWindow() = default;
 
-    void AddProperty(std::unique_ptr<Property> property) { panel->AddProperty(std::move(property)); }
+    Property &GetPooledProperty(size_t key) { return panel->GetPooledProperty(key); }
+    void ShowProperties(std::span<const size_t> keys) { panel->ShowProperties(keys); }
     void ClearRecords() { panel->ClearRecords(); }
 
 protected:
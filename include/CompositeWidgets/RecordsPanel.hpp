@@ -58,7 +58,7 @@ public:
     }
     void SetBGColor(const dr4::Color color) { 
         BGColor = color; 
-        ForceRedraw();
+        RequestRedraw(*this);
     }
     size_t GetRecordCount() const { return records.size(); }
 
@@ -91,6 +91,7 @@ protected:
     void OnSizeChanged() override { relayout(); }
 
     void Redraw() const override {
+        if (!beginLayerRedraw(*this)) return;
         GetTexture().Clear(BGColor);
         for (auto r : records) r->DrawOn(GetTexture());
         if (!scrollBar->IsHidden()) scrollBar->DrawOn(GetTexture());
@@ -107,24 +108,32 @@ protected:
     void relayout() {
         relayoutRecords();
         relayoutScrollBar();
-        ForceRedraw();
+        RequestRedraw(*this);
     }
 
-private:
-    void relayoutRecords() {
+    // Height of everything that can be scrolled through, see Outliner for a panel
+    // whose records are not all widgets.
+    virtual float calculateContentHeight() const { return CalculateRecordsSumHeight(); }
+
+    float calculateScrollOffset() const {
+        return std::fmax(0.0f, scrollBar->GetPercentage() * (calculateContentHeight() - GetSize().y));
+    }
+
+    // Also called on every scroll.
+    virtual void relayoutRecords() {
         dr4::Vec2f curPos = recordsStartPos;
-        double scrollPct = scrollBar->GetPercentage();
-        float scrollOffset = std::fmax(0.0f, scrollPct * (CalculateRecordsSumHeight() - GetSize().y));
+        float scrollOffset = calculateScrollOffset();
 
         for (auto r : records) {
             r->SetPos(curPos - dr4::Vec2f(0, scrollOffset));
-            r->ForceRedraw();
+            RequestRedraw(*r);
             curPos += dr4::Vec2f(0, r->GetSize().y + recordsPadding);
         }
     }
 
+private:
     void relayoutScrollBar() {
-        float totalHeight = CalculateRecordsSumHeight();
+        float totalHeight = calculateContentHeight();
         scrollBar->Show();
         scrollBar->SetSize(SCROLL_BAR_WIDTH, std::max(1.0f, GetSize().y * SCROLL_BAR_HEIGHT_SHARE));
         float posY = (GetSize().y - scrollBar->GetSize().y) / 2;
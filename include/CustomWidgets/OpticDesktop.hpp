@@ -12,6 +12,10 @@
 namespace roa
 {
 
+// edit journal replayed on startup, see EditorWidget::EnableAutosave;
+// a second editor running at the same time gets autosave-2.journal and so on
+inline constexpr char AUTOSAVE_JOURNAL_PATH[] = "autosave.journal";
+
 class OpticDesktop final : public Desktop {
     cum::Manager *pluginManager;
 
@@ -13,12 +13,13 @@
 #include "dr4/event.hpp"
 #include "pp/canvas.hpp"
 #include "Utilities/ROACommon.hpp"
+#include "BasicWidgets/RetainedLayer.hpp"
 #include "BasicWidgets/Window.hpp"
 
 namespace roa
 {
 
-class ColorPicker : public hui::Widget {
+class ColorPicker : public hui::Widget, public RetainedLayer {
 public:
     std::function<void(dr4::Color)> onColorChanged;
 
@@ -51,7 +52,7 @@ public:
         sat_ = s;
         val_ = v;
         UpdateControlsFromHSV();
-        ForceRedraw();
+        RequestRedraw(*this);
         if (onColorChanged) onColorChanged(GetColor());
     }
 
@@ -79,7 +80,7 @@ protected:
                 float y = local.y - sliderOrigin_.y;
                 hueCursorY_ = std::clamp(y, 0.0f, sliderSize_.y - 1.0f);
                 UpdateHSVFromControls();
-                ForceRedraw();
+                RequestRedraw(*this);
                 if (onColorChanged) onColorChanged(GetColor());
                 GetUI()->ReportFocus(this);
                 GetUI()->SetCaptured(this);
@@ -91,7 +92,7 @@ protected:
                 p.y = std::clamp(p.y, paletteOrigin_.y, paletteOrigin_.y + paletteSize_.y - 1.0f);
                 selectorCenter_ = p;
                 UpdateHSVFromControls();
-                ForceRedraw();
+                RequestRedraw(*this);
                 if (onColorChanged) onColorChanged(GetColor());
                 GetUI()->ReportFocus(this);
                 GetUI()->SetCaptured(this);
@@ -117,7 +118,7 @@ protected:
         if (draggingSelector_) {
             selectorCenter_ = (selectorCenter_ + rel).Clamped(paletteOrigin_, paletteOrigin_ + paletteSize_ - dr4::Vec2f{1.0f,1.0f});
             UpdateHSVFromControls();
-            ForceRedraw();
+            RequestRedraw(*this);
             if (onColorChanged) onColorChanged(GetColor());
             return hui::EventResult::HANDLED;
         }
@@ -125,7 +126,7 @@ protected:
             float y = hueCursorY_ + rel.y;
             hueCursorY_ = std::clamp(y, 0.0f, sliderSize_.y - 1.0f);
             UpdateHSVFromControls();
-            ForceRedraw();
+            RequestRedraw(*this);
             if (onColorChanged) onColorChanged(GetColor());
             return hui::EventResult::HANDLED;
         }
@@ -134,6 +135,7 @@ protected:
 
     void Redraw() const override
     {
+        if (!beginLayerRedraw(*this)) return;
         dr4::Texture &tex = GetTexture();
         tex.Clear(FULL_TRANSPARENT);
         dr4::Image *img = tex.GetImage();
@@ -118,7 +118,7 @@ protected:
         toolsMenu->SetPos(GetSize().x - BORDER_THICKNESS * 3 - toolsMenu->GetSize().x, BORDER_THICKNESS * 3);
         pluginsMenu->SetPos(toolsMenu->GetPos() + dr4::Vec2f(0, toolsMenu->GetSize().y + PADDING));
         pluginsMenu->SetSize(100, 100);
-        ForceRedraw();
+        RequestRedraw(*this);
     }
 
     void Redraw() const override {
@@ -188,14 +188,14 @@ protected:
                 dr4::Event::MouseMove dr4ChildEvent(event.pos, event.rel);
                 if (selectedTool) {
                     if (selectedTool->OnMouseMove(dr4ChildEvent)) {
-                        ForceRedraw();
+                        RequestRedraw(*this);
                         return hui::EventResult::HANDLED;
                     }
                 }
 
                 for (auto& shape : shapes) {
                     if (shape.second->OnMouseMove(dr4ChildEvent)) {
-                        ForceRedraw();
+                        RequestRedraw(*this);
                         return hui::EventResult::HANDLED;
                     }
                 }
@@ -218,14 +218,14 @@ protected:
              
                 if (selectedTool) {
                     if (selectedTool->OnMouseDown(dr4ChildEvent)) {
-                        ForceRedraw();
+                        RequestRedraw(*this);
                         return hui::EventResult::HANDLED;
                     }
                 }
 
                 for (auto& shape : shapes) {
                     if (shape.second->OnMouseDown(dr4ChildEvent)) {
-                        ForceRedraw();
+                        RequestRedraw(*this);
                         return hui::EventResult::HANDLED;
                     }
                 }
@@ -251,14 +251,14 @@ protected:
 
             if (selectedTool) {
                 if (selectedTool->OnMouseUp(dr4ChildEvent)) {
-                    ForceRedraw();
+                    RequestRedraw(*this);
                     return hui::EventResult::HANDLED;
                 }
             }
 
             for (auto& shape : shapes) {
                 if (shape.second->OnMouseUp(dr4ChildEvent)) {
-                    ForceRedraw();
+                    RequestRedraw(*this);
                     return hui::EventResult::HANDLED;
                 }
             }
@@ -277,14 +277,14 @@ protected:
 
         if (selectedTool) {
             if (selectedTool->OnKeyDown(dr4ChildEvent)) {
-                ForceRedraw();
+                RequestRedraw(*this);
                 return hui::EventResult::HANDLED;
             }
         }
 
         for (auto& shape : shapes) {
             if (shape.second->OnKeyDown(dr4ChildEvent)) {
-                ForceRedraw();
+                RequestRedraw(*this);
                 return hui::EventResult::HANDLED;
             }
         }
@@ -300,14 +300,14 @@ protected:
 
         if (selectedTool) {
             if (selectedTool->OnKeyUp(dr4ChildEvent)) {
-                ForceRedraw();
+                RequestRedraw(*this);
                 return hui::EventResult::HANDLED;
             }
         }
 
         for (auto& shape : shapes) {
             if (shape.second->OnKeyUp(dr4ChildEvent)) {
-                ForceRedraw();
+                RequestRedraw(*this);
                 return hui::EventResult::HANDLED;
             }
         }
@@ -324,14 +324,14 @@ protected:
 
         if (selectedTool) {
             if (selectedTool->OnText(dr4ChildEvent)) {
-                ForceRedraw();
+                RequestRedraw(*this);
                 return hui::EventResult::HANDLED;
             }
         }
 
         for (auto& shape : shapes) {
             if (shape.second->OnText(dr4ChildEvent)) {
-                ForceRedraw();
+                RequestRedraw(*this);
                 return hui::EventResult::HANDLED;
             }
         }
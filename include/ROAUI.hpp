@@ -1,12 +1,17 @@
 #pragma once
+#include <algorithm>
 #include <cassert>
+#include <chrono>
 #include <exception>
 #include <iostream>
+#include <optional>
 #include <vector>
 #include <functional>
 
 #include "dr4/event.hpp"
 #include "hui/ui.hpp"
+#include "Utilities/NinePatch.hpp"
+#include "Utilities/ROACommon.hpp"
 
 namespace roa
 {
@@ -40,10 +45,31 @@ struct TexturePack {
 };
 
 
+// Rect of `widget` in window coordinates.
+inline dr4::Rect2f GetScreenRect(const hui::Widget &widget) {
+    dr4::Rect2f rect = widget.GetRect();
+    for (const hui::Widget *parent = widget.GetParent(); parent && parent != parent->GetParent(); parent = parent->GetParent()) {
+        rect.pos += parent->GetPos();
+    }
+    return rect;
+}
+
 class UI : public hui::UI {
     std::unique_ptr<dr4::Font> defaultFont = nullptr;
     std::vector<std::pair<dr4::Event::KeyEvent, std::function<void()>>> hotkeyTable;
     TexturePack texturePack;
+    std::vector<std::unique_ptr<NinePatchSkin>> skins;
+    bool frameRequested = false;
+    std::optional<std::chrono::steady_clock::time_point> frameDeadline; // earliest RequestFrameAfter
+
+    // damage of the frame being built, in window coordinates
+    std::optional<dr4::Rect2f> damage;
+    bool fullDamage          = true;
+    bool rootRedrawn         = false;
+    bool rootReportsRedraws  = false;
+
+    static constexpr double EVENT_POLL_SECS     = 0.004;
+    static constexpr double EVENT_POLL_MAX_SECS = 0.032; // bounds the input latency after a long idle
 
 public:
     UI(dr4::Window *window, const std::string &defaultFontPath): hui::UI(window) {
@@ -65,49 +91,143 @@ public:
         hotkeyTable.push_back({keyEvent, onHotkey});
     }
 
-    void Run(double frameDelaySecs= 0.032) {
-        while (GetWindow()->IsOpen()) {
-            while (true) {
-                auto evt = GetWindow()->PollEvent();
-                if (!evt.has_value()) break; 
-
-                if (evt->type == dr4::Event::Type::QUIT ||
-                    (evt->type == dr4::Event::Type::KEY_DOWN && evt->key.sym == dr4::KeyCode::KEYCODE_ESCAPE)) {
-                        GetWindow()->Close();
-                        break;
-                    }
-                
-                if (evt->type == dr4::Event::Type::KEY_DOWN) {
-                    auto hotkeyFunction = findHotkeyFunction(evt->key);
-                    if (hotkeyFunction) {
-                        hotkeyFunction();
-                        continue;
-                    }
-                }
+    // Frames are drawn when events arrive or when a widget asked for one with RequestFrame()
+    // or RequestFrameAfter(), never more often than `targetFrameSecs`. Without either nothing
+    // ticks: dr4 has no blocking wait, so the loop polls for events, doubling the sleep from
+    // EVENT_POLL_SECS up to EVENT_POLL_MAX_SECS while nothing happens.
+    // Idle events carry the measured time since the previous frame.
+    void Run(double targetFrameSecs = 1.0 / 60) {
+        using Clock = std::chrono::steady_clock;
+        const Clock::time_point startTime = Clock::now();
+        auto secondsSince = [](Clock::time_point from, Clock::time_point to) {
+            return std::chrono::duration<double>(to - from).count();
+        };
+
+        Clock::time_point lastFrameTime = startTime;
+        bool eventsSinceFrame = true;
+        double pollSecs = EVENT_POLL_SECS;
+        frameRequested = true;
 
-                ProcessEvent(evt.value());
+        while (GetWindow()->IsOpen()) {
+            if (processEvents()) {
+                eventsSinceFrame = true;
+                pollSecs = EVENT_POLL_SECS;
+            }
+            if (!GetWindow()->IsOpen()) break;
+
+            Clock::time_point now = Clock::now();
+            double sinceFrame = secondsSince(lastFrameTime, now);
+            bool frameDue = (eventsSinceFrame || frameRequested || (frameDeadline && now >= *frameDeadline));
+            if (!frameDue) {
+                double sleepSecs = pollSecs;
+                if (frameDeadline) sleepSecs = std::min(sleepSecs, secondsSince(now, *frameDeadline));
+                GetWindow()->Sleep(sleepSecs);
+                pollSecs = std::min(pollSecs * 2, EVENT_POLL_MAX_SECS);
+                continue;
             }
+            if (sinceFrame < targetFrameSecs) {
+                GetWindow()->Sleep(targetFrameSecs - sinceFrame);
+                continue;
+            }
+
+            // Widgets changed by an event report their own damage through RequestRedraw,
+            // an event that changed nothing recomposites nothing.
+            eventsSinceFrame = false;
+            frameRequested = false;
+            frameDeadline.reset();
+            lastFrameTime = now;
+            pollSecs = EVENT_POLL_SECS;
 
-            double frameStartSecs = GetWindow()->GetTime();
             hui::IdleEvent idleEvent;
-            idleEvent.absTime = frameStartSecs;
-            idleEvent.deltaTime = frameDelaySecs;
+            idleEvent.absTime = secondsSince(startTime, now);
+            idleEvent.deltaTime = sinceFrame;
             OnIdle(idleEvent);
 
-            GetWindow()->Clear({50,50,50,255});
-            if (GetTexture()) GetWindow()->Draw(*GetTexture());
-            GetWindow()->Display();
-
-            GetWindow()->Sleep(frameDelaySecs);
+            // Damage limits what is recomposited into the root texture, not what is presented:
+            // dr4::Window can only draw a whole texture and swap the whole window, so a frame
+            // with any damage still clears, draws and presents the full window.
+            dr4::Texture *texture = GetTexture();
+            if (texture && (rootRedrawn || !rootReportsRedraws)) {
+                GetWindow()->Clear({50,50,50,255});
+                GetWindow()->Draw(*texture);
+                GetWindow()->Display();
+            }
+            damage.reset();
+            fullDamage = false;
+            rootRedrawn = false;
         }
     }
 
+    // Widgets that animate or work across frames call this from OnIdle to get the next frame
+    // at the target rate; otherwise the next frame waits for input.
+    void RequestFrame() { frameRequested = true; }
+
+    // For work due at a known time, like a caret blink: a frame no earlier than `secs` from now.
+    // Like RequestFrame it covers the next frame only, OnIdle asks again if it still needs one.
+    void RequestFrameAfter(double secs) {
+        auto deadline = std::chrono::steady_clock::now() +
+                        std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(secs));
+        if (!frameDeadline || deadline < *frameDeadline) frameDeadline = deadline;
+    }
+
+    // Widgets report what they invalidate, a redraw on an idle frame only recomposites that.
+    void AddDamage(const dr4::Rect2f &screenRect) {
+        if (fullDamage) return;
+        damage = (damage ? uniteRects(*damage, screenRect) : screenRect);
+    }
+    void DamageWidget(const hui::Widget &widget) { AddDamage(GetScreenRect(widget)); }
+    void DamageAll() { fullDamage = true; }
+
+    bool IsFullDamage() const { return fullDamage; }
+    const std::optional<dr4::Rect2f> &GetDamage() const { return damage; }
+
+    // A root that calls NoteRootRedrawn() from Redraw lets frames where nothing changed
+    // skip presenting altogether.
+    void SetRootReportsRedraws(bool reports) { rootReportsRedraws = reports; }
+    void NoteRootRedrawn() { rootRedrawn = true; }
+
     dr4::Font *GetDefaultFont() { return defaultFont.get(); }
 
+    // Rendered on first use and shared by every widget drawing that style.
+    const NinePatchSkin &GetSkin(const SkinStyle &style) {
+        for (auto &skin : skins) {
+            if (skin->GetStyle() == style) return *skin;
+        }
+        skins.push_back(std::make_unique<NinePatchSkin>(*GetWindow(), style));
+        return *skins.back();
+    }
+
     void SetTexturePack(const TexturePack &pack) { texturePack = pack; }
     const TexturePack &GetTexturePack() const { return texturePack; }; 
 
 private:
+    // Handles pending events, returns whether there were any.
+    bool processEvents() {
+        bool any = false;
+        while (true) {
+            auto evt = GetWindow()->PollEvent();
+            if (!evt.has_value()) break; 
+            any = true;
+
+            if (evt->type == dr4::Event::Type::QUIT ||
+                (evt->type == dr4::Event::Type::KEY_DOWN && evt->key.sym == dr4::KeyCode::KEYCODE_ESCAPE)) {
+                    GetWindow()->Close();
+                    break;
+                }
+            
+            if (evt->type == dr4::Event::Type::KEY_DOWN) {
+                auto hotkeyFunction = findHotkeyFunction(evt->key);
+                if (hotkeyFunction) {
+                    hotkeyFunction();
+                    continue;
+                }
+            }
+
+            ProcessEvent(evt.value());
+        }
+        return any;
+    }
+
     std::function<void()> findHotkeyFunction(dr4::Event::KeyEvent hotkey) {
         for (auto hk : hotkeyTable) {
             if (hotkey.sym == hk.first.sym && (hotkey.mods & hk.first.mods)) {
@@ -0,0 +1,191 @@
+#pragma once
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <span>
+#include <spanstream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "RayTracer.h"
+
+namespace roa
+{
+
+// Interns the materials the editor creates by value: objects with equal material
+// records share one RTMaterial, kept in a table addressed by 32-bit indices.
+// Materials are owned by the RTMaterialManager; the table only counts their users
+// (one per editor record) and hands out a private copy before a shared one is edited.
+class MaterialTable {
+public:
+    using Index = uint32_t;
+
+private:
+    struct StringHash {
+        using is_transparent = void;
+        size_t operator()(std::string_view str) const { return std::hash<std::string_view>{}(str); }
+    };
+
+    struct Entry {
+        RTMaterial              *material = nullptr;
+        uint32_t                 users    = 0;
+        std::vector<std::string> keys;   // record texts that currently resolve to this entry
+        std::string              record; // Serialize(*material), refreshed by FinishEdit
+    };
+
+    RTMaterialManager &manager;
+
+    std::vector<Entry>                                                  entries;
+    std::unordered_map<std::string, Index, StringHash, std::equal_to<>> indexByRecord;
+    std::unordered_map<const RTMaterial *, Index>                       indexByMaterial;
+    std::map<std::array<float, 3>, std::string>                         lambertianRecords;
+
+public:
+    explicit MaterialTable(RTMaterialManager &manager): manager(manager) {}
+
+    MaterialTable(const MaterialTable&) = delete;
+    MaterialTable& operator=(const MaterialTable&) = delete;
+
+    // Material for a text record, as RTMaterialManager::deserializeMaterial reads it.
+    // Records that differ only in number formatting end up on the same entry.
+    RTMaterial *Intern(std::string_view record) {
+        auto it = indexByRecord.find(record);
+        if (it != indexByRecord.end()) return entries[it->second].material;
+
+        // ispanstream only reads, so dropping const here is safe
+        std::ispanstream stream(std::span<char>(const_cast<char *>(record.data()), record.size()));
+        RTMaterial *material = manager.deserializeMaterial(stream);
+        if (!material) return nullptr;
+        return intern(material, std::string(record));
+    }
+
+    RTMaterial *Lambertian(std::array<float, 3> color) {
+        auto it = lambertianRecords.find(color);
+        if (it != lambertianRecords.end()) return Intern(it->second);
+
+        RTMaterial *material = manager.MakeLambertian({color[0], color[1], color[2]});
+        lambertianRecords.emplace(color, Serialize(*material));
+        return intern(material, {});
+    }
+
+    // Every editor record holding `material` acquires it once.
+    void Acquire(const RTMaterial *material) {
+        auto it = indexByMaterial.find(material);
+        if (it != indexByMaterial.end()) entries[it->second].users++;
+    }
+
+    void Release(const RTMaterial *material) {
+        auto it = indexByMaterial.find(material);
+        if (it == indexByMaterial.end()) return;
+        assert(entries[it->second].users > 0);
+        entries[it->second].users--;
+    }
+
+    uint32_t GetUsers(const RTMaterial *material) const {
+        auto it = indexByMaterial.find(material);
+        return (it == indexByMaterial.end() ? 0 : entries[it->second].users);
+    }
+
+    // Copy-on-write before `material` is edited by `editors` of its users.
+    // Returns the material they should edit: `material` itself when nobody else uses it,
+    // otherwise a fresh copy the caller must assign to them.
+    RTMaterial *PrepareEdit(RTMaterial *material, uint32_t editors) {
+        auto it = indexByMaterial.find(material);
+        if (it == indexByMaterial.end()) return material;
+
+        Entry &entry = entries[it->second];
+        if (entry.users <= editors) {
+            unkey(entry);
+            return material;
+        }
+
+        entry.users -= editors;
+        std::string record = Serialize(*material);
+        std::istringstream stream(record);
+        RTMaterial *copy = manager.deserializeMaterial(stream);
+        if (!copy) return material;
+
+        Index index = static_cast<Index>(entries.size());
+        entries.push_back({copy, editors, {}, std::move(record)});
+        indexByMaterial.emplace(copy, index);
+        return copy;
+    }
+
+    // Makes an edited material findable by its new value again.
+    void FinishEdit(const RTMaterial *material) {
+        auto it = indexByMaterial.find(material);
+        if (it == indexByMaterial.end()) return;
+
+        Entry &entry = entries[it->second];
+        unkey(entry);
+        entry.record = Serialize(*material);
+        addKey(it->second, entry.record);
+    }
+
+    // Users are dropped, the materials stay interned for the next scene.
+    void ResetUsers() {
+        for (auto &entry : entries) entry.users = 0;
+    }
+
+    Index GetIndex(const RTMaterial *material) const {
+        auto it = indexByMaterial.find(material);
+        assert(it != indexByMaterial.end());
+        return it->second;
+    }
+
+    RTMaterial *Get(Index index) const {
+        assert(index < entries.size());
+        return entries[index].material;
+    }
+
+    size_t GetSize() const { return entries.size(); }
+
+    // Text record of an interned material, so snapshots need not format it again;
+    // nullptr for a material the table does not know.
+    const std::string *GetRecord(const RTMaterial *material) const {
+        auto it = indexByMaterial.find(material);
+        return (it == indexByMaterial.end() ? nullptr : &entries[it->second].record);
+    }
+
+    static std::string Serialize(const RTMaterial &material) {
+        std::ostringstream stream;
+        stream << material;
+        return stream.str();
+    }
+
+private:
+    // `record` is the text `material` was read from, empty if it was built directly.
+    RTMaterial *intern(RTMaterial *material, std::string record) {
+        std::string canonical = Serialize(*material);
+        auto it = indexByRecord.find(canonical);
+        if (it != indexByRecord.end()) {
+            // the fresh material stays with the manager unused, this happens once per spelling
+            if (!record.empty()) addKey(it->second, std::move(record));
+            return entries[it->second].material;
+        }
+
+        Index index = static_cast<Index>(entries.size());
+        entries.push_back({material, 0, {}, canonical});
+        indexByMaterial.emplace(material, index);
+        addKey(index, std::move(canonical));
+        if (!record.empty()) addKey(index, std::move(record));
+        return material;
+    }
+
+    void addKey(Index index, std::string key) {
+        auto [it, inserted] = indexByRecord.try_emplace(key, index);
+        if (inserted) entries[index].keys.push_back(std::move(key));
+    }
+
+    void unkey(Entry &entry) {
+        for (const auto &key : entry.keys) indexByRecord.erase(key);
+        entry.keys.clear();
+    }
+};
+
+} // namespace roa
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include "RayTracer.h"
+#include "RayTracerWidgets/PrimitiveBounds.hpp"
+#include "Utilities/Transform.hpp"
+#include "Utilities/TriangleMesh.hpp"
+
+namespace roa
+{
+
+// One placement of a TriangleMesh. Instances of a mesh share its buffers and BVH,
+// rays are taken into mesh space instead of the mesh being copied.
+// The tracer has no mesh primitive, so `triangles` are the world space PolygonObjects
+// it renders; triangles[0] stands for the instance in the editor.
+struct MeshInstance {
+    std::shared_ptr<const TriangleMesh> mesh;
+    Transform                           toWorld;
+    Transform                           toMesh;
+    std::vector<Primitives *>           triangles;
+
+    AABB GetBounds() const { return ToAABB(toWorld.ApplyToBounds(mesh->GetBounds())); }
+
+    // The transform is affine, so the hit parameter is the same along the world ray.
+    std::optional<float> Intersect(const float (&origin)[3], const float (&direction)[3]) const {
+        float meshOrigin[3], meshDirection[3];
+        toMesh.ApplyToPoint(origin, meshOrigin);
+        toMesh.ApplyToVector(direction, meshDirection);
+
+        std::optional<TriangleMesh::Hit> hit = mesh->Intersect(meshOrigin, meshDirection);
+        if (!hit) return std::nullopt;
+        return hit->t;
+    }
+};
+
+} // namespace roa
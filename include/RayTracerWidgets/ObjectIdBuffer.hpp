@@ -0,0 +1,278 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include "Camera.h"
+#include "RayTracer.h"
+#include "RayTracerWidgets/MeshInstance.hpp"
+#include "RayTracerWidgets/PrimitiveBounds.hpp"
+
+namespace roa
+{
+
+struct Vec3 {
+    float x = 0, y = 0, z = 0;
+
+    Vec3() = default;
+    Vec3(float x_, float y_, float z_): x(x_), y(y_), z(z_) {}
+    Vec3(const gm::IPoint3 &p): x(p.x()), y(p.y()), z(p.z()) {}
+    Vec3(const gm::IVec3f &v): x(v.x()), y(v.y()), z(v.z()) {}
+
+    Vec3 operator+(const Vec3 &o) const { return {x + o.x, y + o.y, z + o.z}; }
+    Vec3 operator-(const Vec3 &o) const { return {x - o.x, y - o.y, z - o.z}; }
+    Vec3 operator*(float k)       const { return {x * k, y * k, z * k}; }
+
+    float Dot(const Vec3 &o)   const { return x * o.x + y * o.y + z * o.z; }
+    Vec3  Cross(const Vec3 &o) const { return {y * o.z - z * o.y, z * o.x - x * o.z, x * o.y - y * o.x}; }
+    Vec3  Normalized() const {
+        float len = std::sqrt(Dot(*this));
+        return (len > 0 ? *this * (1.0f / len) : *this);
+    }
+};
+
+// Pinhole model of the camera for one frame: maps pixels to primary rays and
+// world boxes back to pixel rectangles.
+class CameraFrame {
+    Vec3  origin;
+    Vec3  forward;
+    Vec3  right;
+    Vec3  down;
+    float focal = 1;
+    float viewportWidth = 1;
+    float viewportHeight = 1;
+    int   width = 0;
+    int   height = 0;
+
+public:
+    struct PixelRect {
+        int x0 = 0, y0 = 0;
+        int x1 = 0, y1 = 0; // exclusive
+        bool Empty() const { return x0 >= x1 || y0 >= y1; }
+    };
+
+    CameraFrame(Camera &camera, int width_, int height_):
+        origin(camera.center()),
+        forward(Vec3(camera.direction()).Normalized()),
+        right(Vec3(camera.viewPort().rightDir_).Normalized()),
+        down(Vec3(camera.viewPort().downDir_).Normalized()),
+        viewportWidth(static_cast<float>(camera.viewPort().VIEWPORT_WIDTH)),
+        viewportHeight(static_cast<float>(camera.viewPort().VIEWPORT_HEIGHT)),
+        width(width_),
+        height(height_)
+    {
+        float halfAngle = static_cast<float>(camera.viewPort().viewAngle_.x()) / 2;
+        focal = viewportWidth / 2 / std::tan(halfAngle);
+    }
+
+    int GetWidth()  const { return width;  }
+    int GetHeight() const { return height; }
+    const Vec3 &GetOrigin() const { return origin; }
+
+    Vec3 GetRayDirection(int pixelX, int pixelY) const {
+        float u = (pixelX + 0.5f) / width  - 0.5f;
+        float v = (pixelY + 0.5f) / height - 0.5f;
+        return forward * focal + right * (u * viewportWidth) + down * (v * viewportHeight);
+    }
+
+    PixelRect FullRect() const { return {0, 0, width, height}; }
+
+    // Conservative screen rectangle of a world box, clamped to the frame.
+    PixelRect Project(const std::optional<AABB> &box) const {
+        if (!box) return FullRect();
+
+        float minU = std::numeric_limits<float>::max(), maxU = std::numeric_limits<float>::lowest();
+        float minV = minU, maxV = maxU;
+        for (int corner = 0; corner < 8; corner++) {
+            Vec3 p((corner & 1 ? box->max.x() : box->min.x()),
+                   (corner & 2 ? box->max.y() : box->min.y()),
+                   (corner & 4 ? box->max.z() : box->min.z()));
+            Vec3 rel = p - origin;
+            float depth = rel.Dot(forward);
+            if (depth <= 1e-4f) return FullRect();
+
+            float u = rel.Dot(right) / depth * focal / viewportWidth  + 0.5f;
+            float v = rel.Dot(down)  / depth * focal / viewportHeight + 0.5f;
+            minU = std::min(minU, u); maxU = std::max(maxU, u);
+            minV = std::min(minV, v); maxV = std::max(maxV, v);
+        }
+
+        PixelRect rect;
+        rect.x0 = std::clamp(static_cast<int>(std::floor(minU * width)),      0, width);
+        rect.x1 = std::clamp(static_cast<int>(std::ceil (maxU * width)) + 1,  0, width);
+        rect.y0 = std::clamp(static_cast<int>(std::floor(minV * height)),     0, height);
+        rect.y1 = std::clamp(static_cast<int>(std::ceil (maxV * height)) + 1, 0, height);
+        return rect;
+    }
+};
+
+// Per-pixel id of the primitive seen first along each primary ray.
+// Picking is a lookup and a selection outline is a pass over the ids,
+// so neither needs new rays.
+class ObjectIdBuffer {
+public:
+    static constexpr uint32_t NO_OBJECT = 0;
+
+private:
+    int width  = 0;
+    int height = 0;
+    std::vector<uint32_t>     ids;
+    std::vector<float>        depths;
+    std::vector<Primitives *> objects; // id - 1 -> primitive
+
+public:
+    int GetWidth()  const { return width;  }
+    int GetHeight() const { return height; }
+
+    uint32_t GetId(int x, int y) const {
+        if (x < 0 || y < 0 || x >= width || y >= height) return NO_OBJECT;
+        return ids[y * width + x];
+    }
+
+    Primitives *GetObject(int x, int y) const {
+        uint32_t id = GetId(x, y);
+        return (id == NO_OBJECT ? nullptr : objects[id - 1]);
+    }
+
+    uint32_t FindId(const Primitives *primitive) const {
+        auto it = std::find(objects.begin(), objects.end(), primitive);
+        return (it == objects.end() ? NO_OBJECT : static_cast<uint32_t>(it - objects.begin()) + 1);
+    }
+
+    // `meshOf` returns the mesh instance a primitive stands for, it is then traced through the mesh BVH.
+    // `polygonVerticesOf` returns the vertices of a polygon, so its record need not be parsed.
+    void Rebuild(const CameraFrame &frame,
+                 const std::vector<Primitives *> &primitives,
+                 const std::function<const MeshInstance *(Primitives *)> &meshOf = nullptr,
+                 const std::function<std::span<const gm::IPoint3>(Primitives *)> &polygonVerticesOf = nullptr)
+    {
+        width  = frame.GetWidth();
+        height = frame.GetHeight();
+        ids.assign(static_cast<size_t>(width) * height, NO_OBJECT);
+        depths.assign(static_cast<size_t>(width) * height, std::numeric_limits<float>::max());
+        objects.assign(primitives.begin(), primitives.end());
+
+        for (size_t index = 0; index < objects.size(); index++) {
+            Primitives *primitive = objects[index];
+            const MeshInstance *mesh = (meshOf ? meshOf(primitive) : nullptr);
+            if (mesh) {
+                rasterize(frame, mesh->GetBounds(), makeMeshIntersector(*mesh), static_cast<uint32_t>(index) + 1);
+                continue;
+            }
+            std::span<const gm::IPoint3> vertices = (polygonVerticesOf ? polygonVerticesOf(primitive) : std::span<const gm::IPoint3>());
+            rasterize(frame, ComputeBounds(primitive, vertices), makeIntersector(primitive, vertices), static_cast<uint32_t>(index) + 1);
+        }
+    }
+
+private:
+    void rasterize(const CameraFrame &frame, const std::optional<AABB> &bounds,
+                   const std::function<float(const Vec3 &, const Vec3 &)> &intersect, uint32_t id)
+    {
+        if (!intersect) return;
+        CameraFrame::PixelRect rect = frame.Project(bounds);
+        if (rect.Empty()) return;
+
+        for (int y = rect.y0; y < rect.y1; y++) {
+            for (int x = rect.x0; x < rect.x1; x++) {
+                float t = intersect(frame.GetOrigin(), frame.GetRayDirection(x, y));
+                size_t pixel = static_cast<size_t>(y) * width + x;
+                if (t > 0 && t < depths[pixel]) {
+                    depths[pixel] = t;
+                    ids[pixel] = id;
+                }
+            }
+        }
+    }
+
+    static std::function<float(const Vec3 &, const Vec3 &)> makeMeshIntersector(const MeshInstance &mesh) {
+        return [&mesh](const Vec3 &o, const Vec3 &d) {
+            const float origin[3] = {o.x, o.y, o.z}, direction[3] = {d.x, d.y, d.z};
+            return mesh.Intersect(origin, direction).value_or(-1.0f);
+        };
+    }
+
+    // returns ray parameter of the nearest hit, or a negative value on miss
+    static std::function<float(const Vec3 &, const Vec3 &)> makeIntersector(Primitives *primitive, std::span<const gm::IPoint3> polygonVertices) {
+        Vec3 center(primitive->position());
+
+        if (auto sphere = dynamic_cast<SphereObject *>(primitive)) {
+            float radius = sphere->getRadius();
+            return [center, radius](const Vec3 &o, const Vec3 &d) {
+                Vec3 oc = o - center;
+                float a = d.Dot(d), b = oc.Dot(d), c = oc.Dot(oc) - radius * radius;
+                float disc = b * b - a * c;
+                if (disc < 0) return -1.0f;
+                float sq = std::sqrt(disc);
+                float t = (-b - sq) / a;
+                return (t > 0 ? t : (-b + sq) / a);
+            };
+        }
+
+        if (auto cube = dynamic_cast<CubeObject *>(primitive)) {
+            Vec3 half(cube->getHalfSize());
+            Vec3 lo = center - half, hi = center + half;
+            return [lo, hi](const Vec3 &o, const Vec3 &d) {
+                float tMin = 0, tMax = std::numeric_limits<float>::max();
+                const float os[3] = {o.x, o.y, o.z}, ds[3] = {d.x, d.y, d.z};
+                const float los[3] = {lo.x, lo.y, lo.z}, his[3] = {hi.x, hi.y, hi.z};
+                for (int axis = 0; axis < 3; axis++) {
+                    float inv = 1.0f / ds[axis];
+                    float t0 = (los[axis] - os[axis]) * inv, t1 = (his[axis] - os[axis]) * inv;
+                    if (t0 > t1) std::swap(t0, t1);
+                    tMin = std::max(tMin, t0);
+                    tMax = std::min(tMax, t1);
+                    if (tMin > tMax) return -1.0f;
+                }
+                return tMin;
+            };
+        }
+
+        if (auto plane = dynamic_cast<PlaneObject *>(primitive)) {
+            Vec3 normal(plane->getNormal());
+            return [center, normal](const Vec3 &o, const Vec3 &d) {
+                float denom = normal.Dot(d);
+                if (std::fabs(denom) < 1e-6f) return -1.0f;
+                return (center - o).Dot(normal) / denom;
+            };
+        }
+
+        if (auto polygon = dynamic_cast<PolygonObject *>(primitive)) {
+            std::vector<gm::IPoint3> parsed;
+            if (polygonVertices.empty()) polygonVertices = parsed = ExtractPolygonVertices(polygon);
+            std::vector<Vec3> vertices(polygonVertices.begin(), polygonVertices.end());
+            if (vertices.size() < 3) return nullptr;
+
+            return [vertices = std::move(vertices)](const Vec3 &o, const Vec3 &d) {
+                // triangle fan, Moller-Trumbore per triangle
+                float best = -1.0f;
+                for (size_t i = 1; i + 1 < vertices.size(); i++) {
+                    Vec3 e1 = vertices[i] - vertices[0], e2 = vertices[i + 1] - vertices[0];
+                    Vec3 p = d.Cross(e2);
+                    float det = e1.Dot(p);
+                    if (std::fabs(det) < 1e-8f) continue;
+                    float inv = 1.0f / det;
+                    Vec3 s = o - vertices[0];
+                    float u = s.Dot(p) * inv;
+                    if (u < 0 || u > 1) continue;
+                    Vec3 q = s.Cross(e1);
+                    float v = d.Dot(q) * inv;
+                    if (v < 0 || u + v > 1) continue;
+                    float t = e2.Dot(q) * inv;
+                    if (t > 0 && (best < 0 || t < best)) best = t;
+                }
+                return best;
+            };
+        }
+
+        return nullptr;
+    }
+};
+
+} // namespace roa
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <optional>
+#include <span>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "RayTracer.h"
+#include "Utilities/TriangleMesh.hpp"
+
+namespace roa
+{
+
+struct AABB {
+    gm::IPoint3 min;
+    gm::IPoint3 max;
+
+    AABB United(const AABB &other) const {
+        return {
+            gm::IPoint3(std::min(min.x(), other.min.x()), std::min(min.y(), other.min.y()), std::min(min.z(), other.min.z())),
+            gm::IPoint3(std::max(max.x(), other.max.x()), std::max(max.y(), other.max.y()), std::max(max.z(), other.max.z()))
+        };
+    }
+};
+
+inline AABB ToAABB(const MeshBounds &bounds) {
+    return {gm::IPoint3(bounds.min[0], bounds.min[1], bounds.min[2]), gm::IPoint3(bounds.max[0], bounds.max[1], bounds.max[2])};
+}
+
+// Polygon vertices are only reachable through the scene record:
+// Polygon <x y z> <tag> <count> <vertices...>
+inline std::vector<gm::IPoint3> ExtractPolygonVertices(::PolygonObject *polygon) {
+    assert(polygon);
+    std::stringstream record;
+    record << *polygon;
+
+    std::string name;
+    float x = 0, y = 0, z = 0, tag = 0;
+    size_t count = 0;
+    record >> name >> x >> y >> z >> tag >> count;
+
+    std::vector<gm::IPoint3> vertices;
+    vertices.reserve(count);
+    for (size_t i = 0; i < count && record >> x >> y >> z; i++) {
+        vertices.emplace_back(x, y, z);
+    }
+    return vertices;
+}
+
+// World space bounds of a primitive; std::nullopt for unbounded ones (planes).
+// Polygons use `polygonVertices` when given, their record is parsed otherwise.
+inline std::optional<AABB> ComputeBounds(::Primitives *primitive, std::span<const gm::IPoint3> polygonVertices = {}) {
+    assert(primitive);
+    gm::IPoint3 c = primitive->position();
+
+    if (auto sphere = dynamic_cast<::SphereObject *>(primitive)) {
+        float r = sphere->getRadius();
+        return AABB{gm::IPoint3(c.x() - r, c.y() - r, c.z() - r), gm::IPoint3(c.x() + r, c.y() + r, c.z() + r)};
+    }
+
+    if (auto cube = dynamic_cast<::CubeObject *>(primitive)) {
+        gm::IVec3f h = cube->getHalfSize();
+        return AABB{gm::IPoint3(c.x() - h.x(), c.y() - h.y(), c.z() - h.z()), gm::IPoint3(c.x() + h.x(), c.y() + h.y(), c.z() + h.z())};
+    }
+
+    if (auto polygon = dynamic_cast<::PolygonObject *>(primitive)) {
+        std::vector<gm::IPoint3> parsed;
+        if (polygonVertices.empty()) polygonVertices = parsed = ExtractPolygonVertices(polygon);
+        AABB box{c, c};
+        for (const auto &vertex : polygonVertices) {
+            box = box.United({vertex, vertex});
+        }
+        return box;
+    }
+
+    return std::nullopt;
+}
+
+} // namespace roa
@@ -0,0 +1,109 @@
+#pragma once
+#include <cassert>
+#include <cstdint>
+#include <utility>
+
+#include "RayTracer.h"
+#include "Utilities/SlabArena.hpp"
+
+namespace roa
+{
+
+enum class PrimitiveKind : uint8_t {
+    NONE,
+    SPHERE,
+    PLANE,
+    CUBE,
+    POLYGON
+};
+
+// Refers to a primitive without keeping its address: once the primitive is destroyed
+// the handle resolves to nullptr, even if its slot already holds a new object.
+struct PrimitiveHandle {
+    PrimitiveKind kind = PrimitiveKind::NONE;
+    SlabHandle    slot;
+
+    bool IsNull() const { return kind == PrimitiveKind::NONE; }
+    bool operator==(const PrimitiveHandle &other) const = default;
+};
+
+// Owns the scene primitives, one slab arena per primitive type. The SceneManager only
+// holds pointers into it; erased primitives are destroyed here and their slots reused.
+class PrimitiveStore {
+    SlabArena<SphereObject>  spheres;
+    SlabArena<PlaneObject>   planes;
+    SlabArena<CubeObject>    cubes;
+    SlabArena<PolygonObject> polygons;
+
+public:
+    PrimitiveStore() = default;
+
+    PrimitiveStore(const PrimitiveStore&) = delete;
+    PrimitiveStore& operator=(const PrimitiveStore&) = delete;
+
+    template <typename T, typename... Args>
+    T *Make(Args&&... args) { return arena<T>().Create(std::forward<Args>(args)...); }
+
+    // Primitives not made by the store are left alone.
+    void Destroy(Primitives *primitive) {
+        visit(*this, primitive, [](auto &arena, auto *object) {
+            if (arena.Contains(object)) arena.Destroy(object);
+        });
+    }
+
+    PrimitiveHandle GetHandle(Primitives *primitive) const {
+        PrimitiveHandle handle;
+        visit(*this, primitive, [&handle](const auto &arena, auto *object) {
+            SlabHandle slot = arena.GetHandle(object);
+            if (!slot.IsNull()) handle = {kindOf(object), slot};
+        });
+        return handle;
+    }
+
+    // nullptr for a null handle or one whose primitive was destroyed
+    Primitives *Get(PrimitiveHandle handle) const {
+        switch (handle.kind) {
+        case PrimitiveKind::NONE:    return nullptr;
+        case PrimitiveKind::SPHERE:  return spheres.Get(handle.slot);
+        case PrimitiveKind::PLANE:   return planes.Get(handle.slot);
+        case PrimitiveKind::CUBE:    return cubes.Get(handle.slot);
+        case PrimitiveKind::POLYGON: return polygons.Get(handle.slot);
+        }
+        assert(0);
+        return nullptr;
+    }
+
+    void Clear() {
+        spheres.Clear();
+        planes.Clear();
+        cubes.Clear();
+        polygons.Clear();
+    }
+
+    size_t GetSize() const { return spheres.GetSize() + planes.GetSize() + cubes.GetSize() + polygons.GetSize(); }
+
+private:
+    template <typename T> SlabArena<T> &arena();
+
+    static PrimitiveKind kindOf(const SphereObject *)  { return PrimitiveKind::SPHERE; }
+    static PrimitiveKind kindOf(const PlaneObject *)   { return PrimitiveKind::PLANE; }
+    static PrimitiveKind kindOf(const CubeObject *)    { return PrimitiveKind::CUBE; }
+    static PrimitiveKind kindOf(const PolygonObject *) { return PrimitiveKind::POLYGON; }
+
+    // calls f(arena, object) with the arena of the primitive's type
+    template <typename Self, typename F>
+    static void visit(Self &self, Primitives *primitive, F &&f) {
+        if (!primitive) return;
+        if (auto sphere = dynamic_cast<SphereObject *>(primitive))        f(self.spheres, sphere);
+        else if (auto plane = dynamic_cast<PlaneObject *>(primitive))     f(self.planes, plane);
+        else if (auto cube = dynamic_cast<CubeObject *>(primitive))       f(self.cubes, cube);
+        else if (auto polygon = dynamic_cast<PolygonObject *>(primitive)) f(self.polygons, polygon);
+    }
+};
+
+template <> inline SlabArena<SphereObject>  &PrimitiveStore::arena<SphereObject>()  { return spheres; }
+template <> inline SlabArena<PlaneObject>   &PrimitiveStore::arena<PlaneObject>()   { return planes; }
+template <> inline SlabArena<CubeObject>    &PrimitiveStore::arena<CubeObject>()    { return cubes; }
+template <> inline SlabArena<PolygonObject> &PrimitiveStore::arena<PolygonObject>() { return polygons; }
+
+} // namespace roa
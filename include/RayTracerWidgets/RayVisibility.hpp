@@ -0,0 +1,22 @@
+#pragma once
+
+#include <cstdint>
+
+namespace roa
+{
+
+// Which ray kinds may hit a primitive. Stored per object by Viewport3D and in scene files,
+// but the tracer cannot filter by ray kind: only NONE has an effect, it removes the object
+// from the scene. The other bits are kept so files round-trip.
+enum class RayVisibility : uint8_t {
+    NONE       = 0b00000000,
+    CAMERA     = 0b00000001,
+    SHADOW     = 0b00000010,
+    REFLECTION = 0b00000100,
+    INDIRECT   = 0b00001000,
+    ALL        = 0b00001111,
+};
+
+inline constexpr uint8_t RAY_VISIBILITY_ALL = static_cast<uint8_t>(RayVisibility::ALL);
+
+} // namespace roa
@@ -1,31 +1,90 @@
 #pragma once
 
+#include <algorithm>
 #include <chrono>
 #include <cmath>
 #include <fstream>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <optional>
+#include <span>
 #include <sstream>
+#include <unordered_map>
+#include <unordered_set>
 
 #include "hui/widget.hpp"
 #include "Camera.h"
 #include "RayTracer.h"
 #include "Utilities/ROAGUIRender.hpp"
+#include "BasicWidgets/RetainedLayer.hpp"
 #include "BasicWidgets/Window.hpp"
+#include "RayTracerWidgets/MeshInstance.hpp"
+#include "RayTracerWidgets/PrimitiveBounds.hpp"
+#include "RayTracerWidgets/PrimitiveStore.hpp"
+#include "RayTracerWidgets/RayVisibility.hpp"
+#include "RayTracerWidgets/ObjectIdBuffer.hpp"
 
 namespace roa
 {
 
-class Viewport3D : public hui::Widget {
+class Viewport3D : public hui::Widget, public RetainedLayer {
     static inline constexpr int CAMERA_KEY_CONTROL_DELTA = 10;
     static inline constexpr int CAMERA_MOUSE_RELOCATION_SCALE = 2;
     static constexpr double CAMERA_ZOOM_DELTA = 0.1;
+    static constexpr float CLICK_DRAG_TOLERANCE = 3.0f;
+    const dr4::Color SELECTION_OUTLINE_COLOR = dr4::Color(232, 165, 55, 255);
+
+    static constexpr int    TILE_SIZE                  = 32;
+    static constexpr int    MAX_ACCUMULATED_FRAMES     = 64;
+    static constexpr int    MIN_CONVERGED_FRAMES       = 4;
+    static constexpr float  CONVERGED_MEAN_DELTA       = 0.25f; // mean change per channel (of 255) a frame made to a tile
+    static constexpr int    FAST_EDIT_MARGIN           = 24;
+    static constexpr double FAST_EDIT_SETTLE_SECS      = 0.5;
+    static constexpr int    MAX_RAY_DEPTH              = 5;
+    static constexpr int    PREVIEW_MAX_RAY_DEPTH      = 2;
+    static constexpr int    PREVIEW_ACCUMULATED_FRAMES = 1;
 
     std::unique_ptr<dr4::Image> sceneImage;
+    std::vector<RTPixelColor>   frameBuffer;  // last traced frame
+    std::vector<float>          accumulation; // rgb sums of the frames accumulated per pixel
+
+    // frames accumulated in every TILE_SIZE x TILE_SIZE tile, 0 means the tile is invalid
+    std::vector<int> tileSamples;
+    // tiles whose average stopped changing take no more frames, even below the frame target
+    std::vector<uint8_t> tileConverged;
+    int  tilesX = 0;
+    int  tilesY = 0;
+
+    bool   fastEditMode = true;
+    bool   fastEditPending = false;   // tiles outside the last fast edit are stale until the edited ones converge
+    double lastFastEditTime = 0;
+    double lastIdleTime = 0;
+    bool   previewMode = false;       // shallow single frame renders while a value is dragged
+    PrimitiveStore primitiveStore; // declared first so it outlives the SceneManager pointing into it
     SceneManager sceneManager;
     RTMaterialManager materialManager;
 
+    // objects without the default RAY_VISIBILITY_ALL mask
+    std::unordered_map<Primitives *, uint8_t> visibility;
+    // hidden objects (mask 0) are kept out of the traversed scene
+    std::vector<Primitives *> hiddenPrimitives;
+
+    std::unordered_map<Primitives *, MeshInstance> meshes;    // by triangles[0]
+    std::unordered_map<Primitives *, Primitives *> meshTriangles; // all but triangles[0] -> triangles[0]
+
+    // Built lazily: for a pick, or for the frames that show a selection outline.
+    ObjectIdBuffer objectIds;
+    bool           objectIdsDirty = true;
+    // polygon vertices parsed from the scene record once, when the polygon is added or edited
+    std::unordered_map<Primitives *, std::vector<gm::IPoint3>> polygonVertices;
+    Primitives    *selectedPrimitive = nullptr;
+    std::function<void(Primitives *)> onPickAction = nullptr;
+
     Camera camera;
     bool mouseMiddleKeyPressed  = false;
     bool mouseLeftKeyPressed    = false;
+    float leftDragDistance      = 0;
 
     dr4::Vec2f accumulatedCameraRotation = {0, 0};
     bool       cameraNeedRotation        = false;
@@ -48,16 +107,222 @@ public:
         camera.renderProperties.samplesPerScatter = 1;
         camera.renderProperties.enableLDirect = true;
         camera.renderProperties.enableParallelRender = true;
-        camera.renderProperties.maxRayDepth = 5;
+        camera.renderProperties.maxRayDepth = MAX_RAY_DEPTH;
     }
 
-    void AddRecord(Primitives *primitive) { sceneManager.addObject(primitive); }
-    void EraseRecord(Primitives *primitive) { sceneManager.eraseObject(primitive); }
-    void AddLight(Light *light) { sceneManager.addLight(light); }
-    void AddRecord(gm::IPoint3 position, Primitives *object) { sceneManager.addObject(position, object); }
-    void AddLight(gm::IPoint3 position, Light *light) { sceneManager.addLight(position, light); }
+    void AddRecord(Primitives *primitive) { 
+        sceneManager.addObject(primitive); 
+        cacheMissingShape(primitive);
+        sceneChanged();
+    }
+    // Adds a batch with one round of invalidation instead of one per object.
+    void AddRecords(std::span<Primitives *const> primitives) {
+        if (primitives.empty()) return;
+        for (auto primitive : primitives) {
+            sceneManager.addObject(primitive);
+            cacheMissingShape(primitive);
+        }
+
+        sceneChanged();
+    }
+    // `triangles` are the primitives built for the mesh faces placed by `toWorld`,
+    // triangles[0] becomes the handle of the instance.
+    void AddMesh(std::shared_ptr<const TriangleMesh> mesh, std::vector<Primitives *> triangles, const Transform &toWorld = {}) {
+        assert(mesh && !triangles.empty());
+        for (auto triangle : triangles) sceneManager.addObject(triangle);
+        Primitives *handle = triangles.front();
+        for (size_t i = 1; i < triangles.size(); i++) meshTriangles.emplace(triangles[i], handle);
+
+        meshes[handle] = {std::move(mesh), toWorld, toWorld.Inverse(), std::move(triangles)};
+
+        sceneChanged();
+    }
+
+    const MeshInstance *GetMesh(Primitives *primitive) const {
+        auto it = meshes.find(primitive);
+        return (it == meshes.end() ? nullptr : &it->second);
+    }
+    // the handle of the mesh `primitive` is a triangle of, the primitive itself otherwise
+    Primitives *GetMeshHandle(Primitives *primitive) const {
+        auto it = meshTriangles.find(primitive);
+        return (it == meshTriangles.end() ? primitive : it->second);
+    }
+
+    std::optional<AABB> GetBounds(Primitives *primitive) const {
+        const MeshInstance *mesh = GetMesh(primitive);
+        return (mesh ? mesh->GetBounds() : ComputeBounds(primitive, GetPolygonVertices(primitive)));
+    }
+
+    // Cached vertices of a polygon added as a record, empty for anything else.
+    std::span<const gm::IPoint3> GetPolygonVertices(Primitives *primitive) const {
+        auto it = polygonVertices.find(primitive);
+        return (it == polygonVertices.end() ? std::span<const gm::IPoint3>() : std::span<const gm::IPoint3>(it->second));
+    }
+    // Seeds the cache with the vertices a polygon was made from, before it is added,
+    // so its record is not parsed back. Edits re-parse it through InvalidateObject.
+    void SetPolygonVertices(Primitives *primitive, std::vector<gm::IPoint3> vertices) {
+        assert(primitive);
+        polygonVertices[primitive] = std::move(vertices);
+    }
+
+    // Destroys `primitive`, and the triangles of a mesh, once it is out of the scene.
+    void EraseRecord(Primitives *primitive) { 
+        auto meshIt = meshes.find(primitive);
+        if (meshIt != meshes.end()) {
+            // one pass over the scene instead of an eraseObject lookup per triangle
+            std::unordered_set<Primitives *> erased(meshIt->second.triangles.begin() + 1, meshIt->second.triangles.end());
+            std::erase_if(sceneManager.primitives(), [&erased](Primitives *p){ return erased.contains(p); });
+            for (auto triangle : erased) {
+                meshTriangles.erase(triangle);
+                primitiveStore.Destroy(triangle);
+            }
+            meshes.erase(meshIt);
+        }
+
+        auto hiddenIt = std::find(hiddenPrimitives.begin(), hiddenPrimitives.end(), primitive);
+        if (hiddenIt != hiddenPrimitives.end()) hiddenPrimitives.erase(hiddenIt);
+        else sceneManager.eraseObject(primitive); 
+        visibility.erase(primitive);
+        polygonVertices.erase(primitive);
+        if (selectedPrimitive == primitive) selectedPrimitive = nullptr;
+        primitiveStore.Destroy(primitive);
+        sceneChanged();
+    }
+    void AddLight(Light *light) { 
+        sceneManager.addLight(light); 
+        InvalidateFrame();
+    }
+    void AddRecord(gm::IPoint3 position, Primitives *object) { 
+        sceneManager.addObject(position, object); 
+        cacheShape(object);
+        sceneChanged();
+    }
+    void AddLight(gm::IPoint3 position, Light *light) { 
+        sceneManager.addLight(position, light); 
+        InvalidateFrame();
+    }
+
+    void ClearRecords() { 
+        sceneManager.clear(); 
+        visibility.clear();
+        polygonVertices.clear();
+        hiddenPrimitives.clear();
+        meshes.clear();
+        meshTriangles.clear();
+        selectedPrimitive = nullptr;
+        primitiveStore.Clear();
+        sceneChanged();
+    }
+
+    // The mask is stored as read from scene files, but the tracer cannot filter by ray kind:
+    // only 0 has an effect, it hides the object.
+    uint8_t GetVisibility(Primitives *primitive) const {
+        auto it = visibility.find(primitive);
+        return (it == visibility.end() ? RAY_VISIBILITY_ALL : it->second);
+    }
+
+    void SetVisibility(Primitives *primitive, uint8_t mask) {
+        assert(primitive);
+        mask &= RAY_VISIBILITY_ALL;
+        uint8_t oldMask = GetVisibility(primitive);
+        if (oldMask == mask) return;
+
+        if (mask == RAY_VISIBILITY_ALL) visibility.erase(primitive);
+        else visibility[primitive] = mask;
+
+        if (mask == 0) {
+            sceneManager.eraseObject(primitive);
+            hiddenPrimitives.push_back(primitive);
+        } else if (oldMask == 0) {
+            std::erase(hiddenPrimitives, primitive);
+            sceneManager.addObject(primitive);
+        }
+
+        sceneChanged();
+    }
+
+    const std::vector<Primitives *> &GetHiddenPrimitives() const { return hiddenPrimitives; }
+
+    // `primitive` was edited: refreshes what is cached about its shape.
+    void InvalidateObject(Primitives *primitive) {
+        assert(primitive);
+        cacheShape(primitive);
+        objectIdsDirty = true;
+    }
+
+    void InvalidateFrame() { 
+        std::fill(tileSamples.begin(), tileSamples.end(), 0); 
+        std::fill(tileConverged.begin(), tileConverged.end(), 0);
+        fastEditPending = false;
+    }
+
+    void InvalidateScreenRect(const CameraFrame::PixelRect &rect) {
+        if (rect.Empty()) return;
+        int tx0 = rect.x0 / TILE_SIZE, tx1 = (rect.x1 - 1) / TILE_SIZE;
+        int ty0 = rect.y0 / TILE_SIZE, ty1 = (rect.y1 - 1) / TILE_SIZE;
+        for (int ty = ty0; ty <= ty1 && ty < tilesY; ty++) {
+            for (int tx = tx0; tx <= tx1 && tx < tilesX; tx++) {
+                tileSamples[ty * tilesX + tx] = 0;
+                tileConverged[ty * tilesX + tx] = 0;
+            }
+        }
+    }
+
+    // When fast edit mode is on, only the tiles the edited object covered before and
+    // after the edit restart accumulating; the rest keep their converged colors.
+    // Camera::render has no region parameter, so every frame is still traced whole.
+    // Indirect effects further away are refreshed once the edited tiles converge,
+    // or FAST_EDIT_SETTLE_SECS after the last edit if they take longer.
+    void InvalidateObjectRegion(const std::optional<AABB> &region) {
+        if (!fastEditMode || !region) {
+            InvalidateFrame();
+            return;
+        }
+
+        CameraFrame frame(camera, static_cast<int>(sceneImage->GetWidth()), static_cast<int>(sceneImage->GetHeight()));
+        CameraFrame::PixelRect rect = frame.Project(region);
+        rect.x0 = std::max(0, rect.x0 - FAST_EDIT_MARGIN);
+        rect.y0 = std::max(0, rect.y0 - FAST_EDIT_MARGIN);
+        rect.x1 = std::min(frame.GetWidth(),  rect.x1 + FAST_EDIT_MARGIN);
+        rect.y1 = std::min(frame.GetHeight(), rect.y1 + FAST_EDIT_MARGIN);
+        InvalidateScreenRect(rect);
+
+        fastEditPending = true;
+        lastFastEditTime = lastIdleTime;
+    }
+
+    void SetFastEditMode(bool enabled) { fastEditMode = enabled; }
+    bool IsFastEditMode() const { return fastEditMode; }
+
+    // In preview mode invalid tiles get one frame traced PREVIEW_MAX_RAY_DEPTH deep and
+    // stop there, so a value changed every frame costs one cheap frame per change.
+    // Leaving it re-traces the whole frame at full depth.
+    void SetPreviewMode(bool enabled) {
+        if (previewMode == enabled) return;
+        previewMode = enabled;
+        camera.renderProperties.maxRayDepth = (enabled ? PREVIEW_MAX_RAY_DEPTH : MAX_RAY_DEPTH);
+        if (!enabled) InvalidateFrame();
+        static_cast<UI*>(GetUI())->RequestFrame();
+    }
+    bool IsPreviewMode() const { return previewMode; }
+
+    // Selection only changes the outline composite, no rays are traced for it.
+    void SetSelected(Primitives *primitive) {
+        if (selectedPrimitive == primitive) return;
+        selectedPrimitive = primitive;
+        if (selectedPrimitive && objectIdsDirty) rebuildObjectIds();
+        compositeRect({0, 0, static_cast<int>(sceneImage->GetWidth()), static_cast<int>(sceneImage->GetHeight())});
+        RequestRedraw(*this);
+    }
+    Primitives *GetSelected() const { return selectedPrimitive; }
+
+    void SetOnPickAction(std::function<void(Primitives *)> action) { onPickAction = action; }
+
+    Primitives *PickObject(int pixelX, int pixelY) {
+        if (objectIdsDirty) rebuildObjectIds();
+        return objectIds.GetObject(pixelX, pixelY);
+    }
 
-    void ClearRecords() { sceneManager.clear(); }
 
     std::vector<::Primitives *> &GetPrimitives() { return sceneManager.primitives(); }
     std::vector<::Light *>      &GetLights()     { return sceneManager.lights(); }
@@ -67,6 +332,7 @@ public:
 
     Camera &GetCamera() { return camera; }
     SceneManager &GetSceneManager() { return sceneManager; }
+    PrimitiveStore &GetPrimitiveStore() { return primitiveStore; }
 
     double MeasureRenderTime(const std::size_t MEASURE_COUNT=1) {
         std::pair<int, int> screenResolution = {};
@@ -93,6 +359,7 @@ protected:
                 break;
             case dr4::MouseButtonType::LEFT:
                 mouseLeftKeyPressed = true;
+                leftDragDistance = 0;
                 break;
             default:
                 break;
@@ -111,6 +378,9 @@ protected:
                 mouseMiddleKeyPressed = false;
                 break;
             case dr4::MouseButtonType::LEFT:
+                if (mouseLeftKeyPressed && leftDragDistance < CLICK_DRAG_TOLERANCE) {
+                    pickAt(event.pos - GetPos());
+                }
                 mouseLeftKeyPressed = false;
                 break;
             default:
@@ -121,34 +391,129 @@ protected:
         return hui::EventResult::HANDLED;
     }
 
-    hui::EventResult OnIdle(hui::IdleEvent &) override {
-        static std::vector<RTPixelColor> tempBufer;
+    hui::EventResult OnIdle(hui::IdleEvent &event) override {
+        lastIdleTime = event.absTime;
 
         std::pair<int, int> screenResolution = {};
         screenResolution.first  = static_cast<int>(sceneImage->GetWidth());
         screenResolution.second = static_cast<int>(sceneImage->GetHeight());
-        tempBufer.resize(screenResolution.first * screenResolution.second); 
+        if (frameBuffer.size() != static_cast<size_t>(screenResolution.first * screenResolution.second)) {
+            resizeFrame(screenResolution.first, screenResolution.second);
+        }
         
         if (cameraNeedRotation  ) applyCameraRotation();
         if (cameraNeedRelocation) applyCameraRelocation();
         if (cameraNeedZoom)       applyCameraZoom();
+        if (objectIdsDirty && selectedPrimitive) rebuildObjectIds(); // the outline reads them
+
+        if (fastEditPending && (!frameNeedsSamples() || event.absTime - lastFastEditTime > FAST_EDIT_SETTLE_SECS)) {
+            InvalidateFrame();
+        }
+        // a pending settle needs another frame to fire
+        if (fastEditPending) static_cast<UI*>(GetUI())->RequestFrame();
+        if (!frameNeedsSamples()) return hui::EventResult::UNHANDLED;
         
-        camera.render(sceneManager, screenResolution, tempBufer);
-        // std::cout << "FPS : " << 1000.0 / renderWithTimeMeasure(tempBufer) << "\n";
-        ForceRedraw();
+        camera.render(sceneManager, screenResolution, frameBuffer);
+        // std::cout << "FPS : " << 1000.0 / renderWithTimeMeasure(frameBuffer) << "\n";
+        accumulateTiles();
+        RequestRedraw(*this);
+        static_cast<UI*>(GetUI())->RequestFrame(); // keep refining until every tile has its samples
+
+        return hui::EventResult::UNHANDLED;
+    }
+
+    void resizeFrame(int width, int height) {
+        frameBuffer.assign(static_cast<size_t>(width) * height, RTPixelColor{});
+        accumulation.assign(static_cast<size_t>(width) * height * 3, 0.0f);
+        tilesX = (width  + TILE_SIZE - 1) / TILE_SIZE;
+        tilesY = (height + TILE_SIZE - 1) / TILE_SIZE;
+        tileSamples.assign(static_cast<size_t>(tilesX) * tilesY, 0);
+        tileConverged.assign(static_cast<size_t>(tilesX) * tilesY, 0);
+    }
+
+    int targetSamples() const { return (previewMode ? PREVIEW_ACCUMULATED_FRAMES : MAX_ACCUMULATED_FRAMES); }
+
+    bool tileNeedsSamples(size_t tile, int target) const { return !tileConverged[tile] && tileSamples[tile] < target; }
+
+    bool frameNeedsSamples() const {
+        int target = targetSamples();
+        for (size_t tile = 0; tile < tileSamples.size(); tile++) {
+            if (tileNeedsSamples(tile, target)) return true;
+        }
+        return false;
+    }
+
+    CameraFrame::PixelRect tileRect(int tx, int ty) const {
+        int width  = static_cast<int>(sceneImage->GetWidth());
+        int height = static_cast<int>(sceneImage->GetHeight());
+        return {tx * TILE_SIZE, ty * TILE_SIZE, std::min(width, (tx + 1) * TILE_SIZE), std::min(height, (ty + 1) * TILE_SIZE)};
+    }
+
+    // Adds the traced frame to every tile that has not converged yet. Invalid
+    // tiles restart from it, converged tiles keep what they have. A tile has
+    // converged once a frame moves its average by less than CONVERGED_MEAN_DELTA.
+    void accumulateTiles() {
+        int width  = static_cast<int>(sceneImage->GetWidth());
+        int target = targetSamples();
+
+        for (int ty = 0; ty < tilesY; ty++) {
+            for (int tx = 0; tx < tilesX; tx++) {
+                size_t tile = static_cast<size_t>(ty) * tilesX + tx;
+                if (!tileNeedsSamples(tile, target)) continue;
+                int &samples = tileSamples[tile];
+
+                CameraFrame::PixelRect rect = tileRect(tx, ty);
+                float delta = 0; // |new average - old average| summed over the channels of the tile
+                for (int y = rect.y0; y < rect.y1; y++) {
+                    for (int x = rect.x0; x < rect.x1; x++) {
+                        size_t pixel = static_cast<size_t>(y) * width + x;
+                        float *sum = &accumulation[pixel * 3];
+                        if (samples == 0) sum[0] = sum[1] = sum[2] = 0;
+                        float color[3] = {static_cast<float>(frameBuffer[pixel].r), static_cast<float>(frameBuffer[pixel].g),
+                                          static_cast<float>(frameBuffer[pixel].b)};
+                        for (int c = 0; c < 3; c++) {
+                            if (samples > 0) delta += std::fabs(color[c] - sum[c] / samples) / (samples + 1);
+                            sum[c] += color[c];
+                        }
+                    }
+                }
+                samples++;
+
+                float channels = static_cast<float>(rect.x1 - rect.x0) * (rect.y1 - rect.y0) * 3;
+                if (samples >= MIN_CONVERGED_FRAMES && delta < CONVERGED_MEAN_DELTA * channels) tileConverged[tile] = 1;
+                compositeRect(rect);
+            }
+        }
+    }
 
-        for (int pixelX = 0; pixelX < screenResolution.first; pixelX++) {
-            for (int pixelY = 0; pixelY < screenResolution.second; pixelY++) {
-                int pixelId = pixelY * screenResolution.first + pixelX;
+    // Writes the accumulated colors of `rect` into sceneImage and draws the
+    // selection outline over them from the object id buffer.
+    void compositeRect(const CameraFrame::PixelRect &rect) {
+        int width  = static_cast<int>(sceneImage->GetWidth());
+        int height = static_cast<int>(sceneImage->GetHeight());
+        if (frameBuffer.size() != static_cast<size_t>(width * height) || tileSamples.empty()) return;
+
+        bool idsValid = (objectIds.GetWidth() == width && objectIds.GetHeight() == height);
+        uint32_t selectedId = (idsValid && selectedPrimitive ? objectIds.FindId(selectedPrimitive) : ObjectIdBuffer::NO_OBJECT);
+
+        for (int pixelX = rect.x0; pixelX < rect.x1; pixelX++) {
+            for (int pixelY = rect.y0; pixelY < rect.y1; pixelY++) {
+                int pixelId = pixelY * width + pixelX;
+                int samples = std::max(1, tileSamples[(pixelY / TILE_SIZE) * tilesX + pixelX / TILE_SIZE]);
+                const float *sum = &accumulation[static_cast<size_t>(pixelId) * 3];
 
                 dr4::Color pixelCOlor = 
                 {
-                    tempBufer[pixelId].r,
-                    tempBufer[pixelId].g,
-                    tempBufer[pixelId].b,
-                    tempBufer[pixelId].a
+                    static_cast<uint8_t>(std::clamp(sum[0] / samples, 0.0f, 255.0f)),
+                    static_cast<uint8_t>(std::clamp(sum[1] / samples, 0.0f, 255.0f)),
+                    static_cast<uint8_t>(std::clamp(sum[2] / samples, 0.0f, 255.0f)),
+                    frameBuffer[pixelId].a
                 };
 
+                if (selectedId != ObjectIdBuffer::NO_OBJECT && isOutlinePixel(pixelX, pixelY, selectedId)) {
+                    pixelCOlor = SELECTION_OUTLINE_COLOR;
+                }
+
                 sceneImage->SetPixel
                 (
                     pixelX, 
@@ -157,8 +522,6 @@ protected:
                 );
             }
         }
-
-        return hui::EventResult::UNHANDLED;
     }
 
     hui::EventResult OnKeyDown(hui::KeyEvent &event) override {
@@ -202,6 +565,7 @@ protected:
             return hui::EventResult::HANDLED;
         } 
         if (mouseLeftKeyPressed) {
+            leftDragDistance += std::fabs(event.rel.x) + std::fabs(event.rel.y);
             accumulatedCameraRel += event.rel * CAMERA_MOUSE_RELOCATION_SCALE;
             cameraNeedRelocation = true;
             return hui::EventResult::HANDLED;
@@ -219,11 +583,13 @@ protected:
     }
 
     void Redraw() const override {
+        if (!beginLayerRedraw(*this)) return;
         sceneImage->DrawOn(GetTexture());
     }
 
     void OnSizeChanged() override { 
         sceneImage->SetSize(GetSize());
+        sceneChanged();
     }
 
     void applyCameraRelocation() {
@@ -232,6 +598,7 @@ protected:
 
         gm::IVec3f motionVec = camera.viewPort().rightDir_ * dx + camera.viewPort().downDir_ * dy;
         camera.move(motionVec * (-1));
+        sceneChanged();
     
         accumulatedCameraRel = {0, 0};
         cameraNeedRelocation = false;
@@ -241,6 +608,7 @@ protected:
         double widthRadians  = (double) accumulatedCameraRotation.x / GetScreenResolutionWidth()  * camera.viewPort().viewAngle_.x();
         double heightRadians = (double) accumulatedCameraRotation.y / GetScreenResolutionHeight() * camera.viewPort().viewAngle_.y();
         camera.rotate(-widthRadians, -heightRadians);
+        sceneChanged();
     
         accumulatedCameraRotation = {0, 0};
         cameraNeedRotation = false;
@@ -249,10 +617,56 @@ protected:
     void applyCameraZoom() {
         gm::IVec3f zoomVec = camera.direction() * CAMERA_ZOOM_DELTA * accumulatedCameraZoom;
         camera.move(zoomVec);
+        sceneChanged();
 
         accumulatedCameraZoom = 0;
         cameraNeedZoom = false;
     }   
+
+    // mesh triangles are reached through their mesh, only record polygons are cached
+    void cacheShape(Primitives *primitive) {
+        if (meshes.contains(primitive)) return;
+        if (auto polygon = dynamic_cast<PolygonObject *>(primitive)) polygonVertices[primitive] = ExtractPolygonVertices(polygon);
+    }
+
+    // polygons seeded through SetPolygonVertices keep their vertices
+    void cacheMissingShape(Primitives *primitive) {
+        if (!polygonVertices.contains(primitive)) cacheShape(primitive);
+    }
+
+    void sceneChanged() {
+        objectIdsDirty = true;
+        InvalidateFrame();
+    }
+
+    void rebuildObjectIds() {
+        CameraFrame frame(camera, static_cast<int>(sceneImage->GetWidth()), static_cast<int>(sceneImage->GetHeight()));
+        // mesh triangles are picked through their handle
+        std::vector<Primitives *> pickable;
+        if (!meshTriangles.empty()) {
+            pickable.reserve(sceneManager.primitives().size() - meshTriangles.size());
+            std::copy_if(sceneManager.primitives().begin(), sceneManager.primitives().end(), std::back_inserter(pickable),
+                         [this](Primitives *primitive){ return !meshTriangles.contains(primitive); });
+        }
+
+        // hidden objects are not in the SceneManager, everything else is seen by the camera
+        objectIds.Rebuild(frame, meshTriangles.empty() ? sceneManager.primitives() : pickable,
+            [this](Primitives *primitive) { return GetMesh(primitive); },
+            [this](Primitives *primitive) { return GetPolygonVertices(primitive); });
+        objectIdsDirty = false;
+    }
+
+    bool isOutlinePixel(int pixelX, int pixelY, uint32_t selectedId) const {
+        if (objectIds.GetId(pixelX, pixelY) != selectedId) return false;
+        return objectIds.GetId(pixelX - 1, pixelY) != selectedId || objectIds.GetId(pixelX + 1, pixelY) != selectedId ||
+               objectIds.GetId(pixelX, pixelY - 1) != selectedId || objectIds.GetId(pixelX, pixelY + 1) != selectedId;
+    }
+
+    void pickAt(dr4::Vec2f localPos) {
+        Primitives *picked = PickObject(static_cast<int>(localPos.x), static_cast<int>(localPos.y));
+        SetSelected(picked);
+        if (onPickAction) onPickAction(picked);
+    }
 private:
     double renderWithTimeMeasure(std::vector<RTPixelColor> &bufer) {
         std::pair<int, int> screenResolution = {};
@@ -283,9 +697,20 @@ public:
     ~Viewport3DWindow() = default;
 
     void AddRecord(Primitives *object) { viewport3D->AddRecord(object); }
+    void AddRecords(std::span<Primitives *const> objects) { viewport3D->AddRecords(objects); }
     void EraseRecord(Primitives *deletedPrimitive) {
         viewport3D->EraseRecord(deletedPrimitive);
     }
+    void AddMesh(std::shared_ptr<const TriangleMesh> mesh, std::vector<Primitives *> triangles, const Transform &toWorld = {}) {
+        viewport3D->AddMesh(std::move(mesh), std::move(triangles), toWorld);
+    }
+    const MeshInstance *GetMesh(Primitives *primitive) const { return viewport3D->GetMesh(primitive); }
+    Primitives *GetMeshHandle(Primitives *primitive) const { return viewport3D->GetMeshHandle(primitive); }
+    std::optional<AABB> GetBounds(Primitives *primitive) const { return viewport3D->GetBounds(primitive); }
+    std::span<const gm::IPoint3> GetPolygonVertices(Primitives *primitive) const { return viewport3D->GetPolygonVertices(primitive); }
+    void SetPolygonVertices(Primitives *primitive, std::vector<gm::IPoint3> vertices) {
+        viewport3D->SetPolygonVertices(primitive, std::move(vertices));
+    }
 
     void AddLight(Light *light)        { viewport3D->AddLight(light); }
     void AddRecord(gm::IPoint3 position, Primitives *object) { viewport3D->AddRecord(position, object); }
@@ -293,6 +718,21 @@ public:
 
     void ClearRecords() { viewport3D->ClearRecords(); }
 
+    uint8_t GetVisibility(Primitives *primitive) const { return viewport3D->GetVisibility(primitive); }
+    void SetVisibility(Primitives *primitive, uint8_t mask) { viewport3D->SetVisibility(primitive, mask); }
+    const std::vector<Primitives *> &GetHiddenPrimitives() const { return viewport3D->GetHiddenPrimitives(); }
+
+    void InvalidateObject(Primitives *primitive) { viewport3D->InvalidateObject(primitive); }
+    void SetSelected(Primitives *primitive) { viewport3D->SetSelected(primitive); }
+    Primitives *GetSelected() const { return viewport3D->GetSelected(); }
+    void SetOnPickAction(std::function<void(Primitives *)> action) { viewport3D->SetOnPickAction(action); }
+
+    void InvalidateFrame() { viewport3D->InvalidateFrame(); }
+    void InvalidateObjectRegion(const std::optional<AABB> &region) { viewport3D->InvalidateObjectRegion(region); }
+    void SetFastEditMode(bool enabled) { viewport3D->SetFastEditMode(enabled); }
+    bool IsFastEditMode() const { return viewport3D->IsFastEditMode(); }
+    void SetPreviewMode(bool enabled) { viewport3D->SetPreviewMode(enabled); }
+
     std::vector<::Primitives *> &GetPrimitives() { return viewport3D->GetPrimitives(); }
     std::vector<::Light *>      &GetLights()     { return viewport3D->GetLights(); }
 
@@ -301,6 +741,7 @@ public:
 
     Camera &GetCamera() { return viewport3D->GetCamera(); }
     SceneManager &GetSceneManager() { return viewport3D->GetSceneManager(); }
+    PrimitiveStore &GetPrimitiveStore() { return viewport3D->GetPrimitiveStore(); }
 
     double MeasureRenderTime(const std::size_t MEASURE_COUNT=1) {
         return viewport3D->MeasureRenderTime(MEASURE_COUNT);
@@ -0,0 +1,170 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace roa
+{
+
+struct ParsedScene;
+
+// Binary scene layout (native endianness):
+//   BinarySceneHeader
+//   one array per BinarySceneSection, each starting on a SECTION_ALIGNMENT boundary
+// Every record type has its own array; ORDER holds, for each record in file order, the
+// section it is stored in, so a round trip keeps the order of the text file.
+// Materials are stored as numbers; lights as their text records and meshes as the path of
+// their file, both in the STRINGS section. GROUPS lists the records that belong to an
+// instance group, by their index in ORDER.
+inline constexpr char     BINARY_SCENE_MAGIC[4]    = {'R', 'O', 'A', 'S'};
+inline constexpr uint32_t BINARY_SCENE_VERSION     = 4;
+inline constexpr char     BINARY_SCENE_EXTENSION[] = ".roab";
+inline constexpr size_t   SECTION_ALIGNMENT        = 16;
+
+enum class BinarySceneSection : uint32_t {
+    MATERIALS,
+    SPHERES,
+    PLANES,
+    CUBES,
+    POLYGONS,
+    VERTICES,
+    LIGHTS,
+    STRINGS,
+    ORDER,
+    MESHES,
+    GROUPS,
+    COUNT
+};
+
+inline constexpr size_t BINARY_SCENE_SECTION_COUNT = static_cast<size_t>(BinarySceneSection::COUNT);
+
+struct BinarySectionEntry {
+    uint64_t offset;
+    uint64_t count;
+};
+
+struct BinarySceneHeader {
+    char               magic[4];
+    uint32_t           version;
+    uint32_t           sectionCount;
+    uint32_t           reserved;
+    BinarySectionEntry sections[BINARY_SCENE_SECTION_COUNT];
+};
+
+struct BinaryStringRef {
+    uint32_t offset;
+    uint32_t length;
+};
+
+inline constexpr size_t BINARY_MATERIAL_TYPE_SIZE  = 16;
+inline constexpr size_t BINARY_MATERIAL_MAX_PARAMS = 16;
+
+// A material record as numbers: `type` is its first word (e.g. "Metal"), zero padded,
+// `params` are the numbers that follow it.
+struct BinaryMaterial {
+    char     type[BINARY_MATERIAL_TYPE_SIZE];
+    uint32_t paramCount;
+    float    params[BINARY_MATERIAL_MAX_PARAMS];
+
+    std::string_view GetType() const { return {type, strnlen(type, BINARY_MATERIAL_TYPE_SIZE)}; }
+    bool operator==(const BinaryMaterial &other) const = default;
+};
+
+struct BinarySphere {
+    float    position[3];
+    float    radius;
+    uint32_t material;
+    uint32_t visibility;
+};
+
+struct BinaryPlane {
+    float    position[3];
+    float    normal[3];
+    uint32_t material;
+    uint32_t visibility;
+};
+
+struct BinaryCube {
+    float    position[3];
+    float    halfSize[3];
+    uint32_t material;
+    uint32_t visibility;
+};
+
+struct BinaryPolygon {
+    float    position[3];
+    uint32_t firstVertex;
+    uint32_t vertexCount;
+    uint32_t material;
+    uint32_t visibility;
+    uint32_t reserved;
+};
+
+struct BinaryVertex {
+    float position[3];
+};
+
+struct BinaryLight {
+    BinaryStringRef record;
+};
+
+struct BinaryMesh {
+    float           toWorld[12]; // row-major 3x4
+    BinaryStringRef path;
+    uint32_t        material;
+    uint32_t        visibility;
+};
+
+struct BinaryGroupMember {
+    uint64_t group;
+    uint32_t record; // index in ORDER, members are sorted by it
+    uint32_t reserved;
+};
+
+// Scene arrays being assembled for WriteBinaryScene.
+struct BinarySceneData {
+    std::vector<BinaryMaterial> materials;
+    std::vector<BinarySphere>   spheres;
+    std::vector<BinaryPlane>    planes;
+    std::vector<BinaryCube>     cubes;
+    std::vector<BinaryPolygon>  polygons;
+    std::vector<BinaryVertex>   vertices;
+    std::vector<BinaryLight>    lights;
+    std::vector<BinaryMesh>     meshes;
+    std::string                 strings;
+    std::vector<uint8_t>        order; // BinarySceneSection of every record
+    std::vector<BinaryGroupMember> groups;
+
+    BinaryStringRef AddString(std::string_view str);
+    // identical materials share one table entry
+    uint32_t AddMaterial(const BinaryMaterial &material);
+    void     AddLight(std::string_view record);
+
+private:
+    std::unordered_map<std::string, uint32_t> materialIndices; // by the bytes of the material
+};
+
+// Reads a material record of the text grammar, false if it does not fit a BinaryMaterial.
+bool ParseBinaryMaterial(std::string_view record, BinaryMaterial &material);
+
+bool WriteBinaryScene(const std::string &path, const BinarySceneData &data);
+
+bool IsBinaryScenePath(const std::string &path);
+
+// Fills the same records the text parser produces, so both formats can share one loading path.
+// Sections are read straight into the scene's arrays; materials go to ParsedScene::materials
+// and the records refer to them by index instead of by text.
+bool ReadBinaryScene(const std::string &path, ParsedScene &scene);
+
+// Groups parsed records into binary sections, identical materials are stored once.
+// False if a material record does not fit a BinaryMaterial.
+bool BuildBinarySceneData(const ParsedScene &scene, BinarySceneData &data);
+
+// Converts between the text and binary scene formats, direction is picked by extension.
+bool ConvertSceneFile(const std::string &srcPath, const std::string &dstPath);
+
+} // namespace roa
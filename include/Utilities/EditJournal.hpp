@@ -0,0 +1,112 @@
+#pragma once
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace roa
+{
+
+// Editable fields of a primitive as journaled by EditorWidget.
+enum class SceneField : uint8_t {
+    POSITION_X, POSITION_Y, POSITION_Z,
+    DIFFUSE_X,  DIFFUSE_Y,  DIFFUSE_Z,
+    SPECULAR_X, SPECULAR_Y, SPECULAR_Z,
+    EMITTED_X,  EMITTED_Y,  EMITTED_Z,
+    RADIUS,
+    HALF_SIZE_X, HALF_SIZE_Y, HALF_SIZE_Z,
+    NORMAL_X,    NORMAL_Y,    NORMAL_Z,
+    VISIBILITY,
+    COUNT
+};
+
+// Journal lines:
+//   A <id> <scene line>        object added, <scene line> is in the text scene grammar
+//                              (a mesh is one `Mesh` line naming its file)
+//   D <id>                     object deleted
+//   S <id> <field> <value>     field set
+//   G <id>                     object became the prototype of an instance group named
+//                              by <id>; its instances are added with `Group <id>`
+// Compaction replaces the whole file by `A` lines of the current scene, so the file
+// alone always describes the scene: its latest full save followed by the edits since.
+struct JournalEntry {
+    enum class Kind : uint8_t { ADD, ERASE, SET, GROUP };
+
+    Kind             kind     = Kind::SET;
+    uint64_t         objectId = 0;
+    SceneField       field    = SceneField::POSITION_X;
+    float            value    = 0;
+    std::string_view record; // ADD, points into the buffer given to ParseJournal
+};
+
+// Append-only edit log. Appends only format into memory; a background thread
+// writes them out and fsyncs at most FLUSH_INTERVAL after they were made.
+class EditJournal {
+public:
+    static constexpr std::chrono::milliseconds FLUSH_INTERVAL{200};
+
+private:
+    std::string path;
+    int         fd     = -1; // owned by the writer thread while open
+    int         lockFd = -1; // flock of the claimed journal, held until destruction
+
+    mutable std::mutex      mutex;
+    bool                    opened = false;
+    std::condition_variable wakeUp;
+    std::vector<char>       pending;
+    std::function<void(std::vector<char> &)> compaction;
+    bool                    stopping = false;
+    size_t                  entriesSinceCompaction = 0;
+
+    std::thread writer;
+
+public:
+    EditJournal() = default;
+    ~EditJournal();
+
+    EditJournal(const EditJournal&) = delete;
+    EditJournal& operator=(const EditJournal&) = delete;
+
+    // Locks the first of `path`, `<stem>-2<ext>`, `<stem>-3<ext>`, ... that no other process
+    // holds and returns it, empty if none could be locked. Editors running side by side
+    // each keep their own journal; one left by a crashed editor is free to be claimed again.
+    std::string Claim(const std::string &path);
+
+    // Opens `path` for appending and starts the writer thread.
+    bool Open(const std::string &path);
+    void Close();
+    bool IsOpen() const {
+        std::lock_guard lock(mutex);
+        return opened;
+    }
+
+    void AppendAdd(uint64_t objectId, std::string_view sceneLine);
+    void AppendErase(uint64_t objectId);
+    void AppendSet(uint64_t objectId, SceneField field, float value);
+    void AppendGroup(uint64_t objectId);
+
+    // `formatSnapshot` appends the whole current scene as `A` lines. It runs on the
+    // writer thread, so it may only read data it owns. Edits appended before this call
+    // are dropped, they are part of the snapshot.
+    void Compact(std::function<void(std::vector<char> &lines)> formatSnapshot);
+
+    size_t GetEntriesSinceCompaction();
+
+private:
+    void appendIdLine(char kind, uint64_t objectId);
+    void append(std::string_view line);
+    void writerLoop();
+};
+
+// Formats one `A` line from a scene line (without its trailing newline).
+void FormatJournalAdd(uint64_t objectId, std::string_view sceneLine, std::vector<char> &out);
+
+// Parses journal text. A torn last line (no newline) is ignored.
+std::vector<JournalEntry> ParseJournal(std::string_view text);
+
+} // namespace roa
@@ -0,0 +1,19 @@
+#pragma once
+#include <cstddef>
+#include <string_view>
+
+// Icons rasterized at build time by IconAtlasBaker from assets/icons/IconAtlas.txt.
+// All pixels live in one RGBA blob, an entry points at its rows.
+struct BakedIcon {
+    const char *path;
+    int         width;
+    int         height;
+    size_t      offset; // into BAKED_ICON_PIXELS
+};
+
+extern const unsigned char BAKED_ICON_PIXELS[];
+extern const BakedIcon     BAKED_ICONS[];
+extern const size_t        BAKED_ICON_COUNT;
+
+// width * height * 4 bytes of `path` baked at that size, nullptr if it was not baked.
+const unsigned char *FindBakedIcon(std::string_view path, int width, int height);
@@ -0,0 +1,35 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Utilities/TriangleMesh.hpp"
+
+namespace roa
+{
+
+// Vertex positions and triangle indices of an imported file, polygons are fan triangulated.
+struct ImportedMesh {
+    std::vector<MeshVertex> vertices;
+    std::vector<uint32_t>   indices;
+};
+
+// Both readers walk a read-only mapping of the file front to back, so only
+// the output buffers are held in memory. Only positions and faces are read.
+
+// `v` and `f` records; `f` accepts v, v/vt, v//vn, v/vt/vn and negative indices.
+bool ImportOBJ(const std::string &path, ImportedMesh &mesh);
+
+// binary_little_endian and binary_big_endian 1.0 with a `vertex` element holding
+// x, y, z and a `face` element holding a vertex_indices (or vertex_index) list.
+bool ImportPLY(const std::string &path, ImportedMesh &mesh);
+
+// .obj or .ply
+bool IsMeshPath(const std::string &path);
+bool ImportMesh(const std::string &path, ImportedMesh &mesh);
+
+// ImportMesh plus the BVH build; nullptr if the file cannot be read or has no triangles.
+std::shared_ptr<const TriangleMesh> LoadTriangleMesh(const std::string &path);
+
+} // namespace roa
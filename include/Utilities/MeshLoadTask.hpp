@@ -0,0 +1,54 @@
+#pragma once
+#include <atomic>
+#include <cassert>
+#include <memory>
+#include <string>
+#include <thread>
+
+#include "Utilities/MeshImport.hpp"
+#include "Utilities/TriangleMesh.hpp"
+
+namespace roa
+{
+
+// Imports an OBJ/PLY file and builds its BVH on a background thread.
+// The UI thread polls GetState() and takes the mesh once it is READY.
+class MeshLoadTask {
+public:
+    enum class State {
+        LOADING,
+        READY,
+        FAILED
+    };
+
+private:
+    std::string                         path;
+    std::shared_ptr<const TriangleMesh> mesh;
+    std::atomic<State>                  state = State::LOADING;
+    std::jthread                        worker;
+
+public:
+    explicit MeshLoadTask(const std::string &path_):
+        path(path_),
+        worker([this]() {
+            mesh = LoadTriangleMesh(path);
+            state.store(mesh ? State::READY : State::FAILED, std::memory_order_release);
+        })
+    {}
+
+    // joins the worker
+    ~MeshLoadTask() = default;
+
+    MeshLoadTask(const MeshLoadTask&) = delete;
+    MeshLoadTask& operator=(const MeshLoadTask&) = delete;
+
+    State GetState() const { return state.load(std::memory_order_acquire); }
+    const std::string &GetPath() const { return path; }
+
+    const std::shared_ptr<const TriangleMesh> &GetMesh() const {
+        assert(GetState() == State::READY);
+        return mesh;
+    }
+};
+
+} // namespace roa
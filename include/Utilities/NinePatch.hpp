@@ -0,0 +1,164 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include "dr4/texture.hpp"
+#include "dr4/window.hpp"
+#include "Utilities/ROACommon.hpp"
+#include "Utilities/ROAGUIRender.hpp"
+
+namespace roa
+{
+
+// Look of a rounded chrome element. `fill` empty means a frame whose inside is left alone.
+// Corner pixels outside the shape are flattened onto `matte`, so a skin drawn over
+// existing content still cuts its corners out.
+struct SkinStyle {
+    int                       radius = 0;
+    int                       border = 0;
+    dr4::Color                borderColor = FULL_TRANSPARENT;
+    std::optional<dr4::Color> fill;
+    dr4::Color                matte = FULL_TRANSPARENT;
+
+    bool operator==(const SkinStyle &other) const = default;
+};
+
+// A SkinStyle rendered once as four corner tiles. Any size is then drawn with the corners
+// plus rectangles for the straight border bands and the fill, so the cost of drawing
+// does not grow with the element's area. Sizes too small for the corners are drawn
+// per pixel as before.
+class NinePatchSkin {
+    SkinStyle style;
+    int       cornerSize;
+
+    std::array<std::unique_ptr<dr4::Image>, 4> corners; // top left, top right, bottom left, bottom right
+    std::unique_ptr<dr4::Rectangle> band;
+    std::unique_ptr<dr4::Rectangle> fill;
+
+public:
+    NinePatchSkin(dr4::Window &window, const SkinStyle &style)
+        : style(style),
+          cornerSize(std::max({style.radius, style.border, 0})),
+          band(window.CreateRectangle()),
+          fill(window.CreateRectangle())
+    {
+        band->SetFillColor(style.borderColor);
+        if (style.fill) this->fill->SetFillColor(*style.fill);
+
+        int C = cornerSize;
+        if (C == 0) return;
+
+        std::vector<dr4::Color> pixels = renderCorners();
+        for (int corner = 0; corner < 4; corner++) {
+            corners[corner].reset(window.CreateImage());
+            corners[corner]->SetSize({float(C), float(C)});
+
+            int x0 = (corner % 2) * C, y0 = (corner / 2) * C;
+            for (int y = 0; y < C; y++) {
+                for (int x = 0; x < C; x++) corners[corner]->SetPixel(x, y, pixels[(y0 + y) * 2 * C + x0 + x]);
+            }
+        }
+    }
+
+    NinePatchSkin(const NinePatchSkin&) = delete;
+    NinePatchSkin& operator=(const NinePatchSkin&) = delete;
+
+    const SkinStyle &GetStyle() const { return style; }
+
+    // Draws the skin over the whole `texture` of the given size.
+    void DrawOn(dr4::Texture &texture, dr4::Vec2f size) const {
+        int W = static_cast<int>(size.x);
+        int H = static_cast<int>(size.y);
+        if (W <= 0 || H <= 0) return;
+
+        int C = cornerSize;
+        if (W < 2 * C || H < 2 * C) {
+            drawPerPixel(texture, W, H);
+            return;
+        }
+
+        float w = float(W), h = float(H), c = float(C), b = float(style.border);
+
+        if (style.fill) {
+            drawRect(*fill, texture, {b, c}, {w - 2 * b, h - 2 * c});
+            drawRect(*fill, texture, {c, b}, {w - 2 * c, c - b});
+            drawRect(*fill, texture, {c, h - c}, {w - 2 * c, c - b});
+        }
+        if (style.border > 0) {
+            drawRect(*band, texture, {c, 0},     {w - 2 * c, b});
+            drawRect(*band, texture, {c, h - b}, {w - 2 * c, b});
+            drawRect(*band, texture, {0, c},     {b, h - 2 * c});
+            drawRect(*band, texture, {w - b, c}, {b, h - 2 * c});
+        }
+
+        if (C == 0) return;
+        const dr4::Vec2f cornerPos[4] = {{0, 0}, {w - c, 0}, {0, h - c}, {w - c, h - c}};
+        for (int corner = 0; corner < 4; corner++) {
+            corners[corner]->SetPos(cornerPos[corner]);
+            corners[corner]->DrawOn(texture);
+        }
+    }
+
+private:
+    static void drawRect(dr4::Rectangle &rect, dr4::Texture &texture, dr4::Vec2f pos, dr4::Vec2f size) {
+        if (size.x <= 0 || size.y <= 0) return;
+        rect.SetPos(pos);
+        rect.SetSize(size);
+        rect.DrawOn(texture);
+    }
+
+    // Corners of a 2C x 2C shape are the corners of any larger one.
+    std::vector<dr4::Color> renderCorners() const {
+        int C = cornerSize;
+        std::vector<dr4::Color> pixels(static_cast<size_t>(4) * C * C, FULL_TRANSPARENT);
+        RoundedShapeLayout shape(2 * C, 2 * C, style.radius, style.border);
+        for (int y = 0; y < 2 * C; y++) {
+            for (int x = 0; x < 2 * C; x++) {
+                uint8_t outer = shape.Outer(x, y);
+                uint8_t inner = shape.Inner(x, y);
+
+                dr4::Color color = style.borderColor;
+                uint8_t coverage = outer;
+                if (style.fill) {
+                    if (style.border == 0) color = *style.fill;
+                    else color = LerpColor(style.borderColor, *style.fill, inner);
+                } else {
+                    coverage = std::min<uint8_t>(outer, 255 - inner);
+                }
+                pixels[y * 2 * C + x] = overMatte(color, coverage, 255 - outer);
+            }
+        }
+        return pixels;
+    }
+
+    // `color` covering `coverage` of the pixel and the matte `matteCoverage` of it.
+    dr4::Color overMatte(dr4::Color color, uint8_t coverage, uint8_t matteCoverage) const {
+        float colorA = color.a / 255.0f * coverage / 255.0f;
+        float matteA = style.matte.a / 255.0f * matteCoverage / 255.0f;
+        float a = colorA + matteA;
+        if (a <= 0) return FULL_TRANSPARENT;
+
+        auto channel = [&](uint8_t c, uint8_t m) { return static_cast<uint8_t>(std::lround((c * colorA + m * matteA) / a)); };
+        return dr4::Color(channel(color.r, style.matte.r), channel(color.g, style.matte.g),
+                          channel(color.b, style.matte.b), static_cast<uint8_t>(std::lround(std::min(a, 1.0f) * 255)));
+    }
+
+    void drawPerPixel(dr4::Texture &texture, int W, int H) const {
+        dr4::Image *image = texture.GetImage();
+        assert(image);
+
+        auto putPixel = [image](int x, int y, dr4::Color c) { image->SetPixel(x, y, c); };
+        if (style.fill) DrawBlenderRoundedRectangle(W, H, style.radius, style.border, style.borderColor, *style.fill, putPixel);
+        else DrawBlenderRoundedFrame(W, H, style.radius, style.border, style.borderColor, putPixel);
+
+        texture.Clear(FULL_TRANSPARENT);
+        image->DrawOn(texture);
+    }
+};
+
+} // namespace roa
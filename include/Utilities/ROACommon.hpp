@@ -28,6 +28,9 @@ const dr4::Color FULL_TRANSPARENT = dr4::Color{0, 0, 0, 0};
 
 dr4::Vec2f getClampedDotInRect(const dr4::Vec2f dot, const dr4::Rect2f rect);
 
+dr4::Rect2f uniteRects(const dr4::Rect2f a, const dr4::Rect2f b);
+bool        rectsIntersect(const dr4::Rect2f a, const dr4::Rect2f b);
+
 
 template <EventDerived T>
 inline bool checkEventType(const hui::Event &event) {
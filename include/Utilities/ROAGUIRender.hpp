@@ -2,7 +2,8 @@
 #include <cmath>
 #include <cstdint>
 #include <algorithm>
-#include <functional>
+#include <unordered_map>
+#include <vector>
 
 #include "dr4/math/color.hpp"
 
@@ -23,75 +24,153 @@ inline bool InsideRounded(int x, int y, int w, int h, int R) {
     return dx*dx + dy*dy <= R * R;
 }
 
+// Anti-aliased coverage (0..255) of a corner of radius R, indexed [(oy - 1) * R + ox - 1]
+// by a pixel's offsets ox, oy in 1..R outwards from the straight edges. Every corner of
+// every shape with this radius reads the same mask, so it is built once per radius.
+inline const std::vector<uint8_t> &GetRoundedCornerMask(int R) {
+    static std::unordered_map<int, std::vector<uint8_t>> masks;
+
+    auto [it, inserted] = masks.try_emplace(R);
+    if (inserted) {
+        std::vector<uint8_t> &mask = it->second;
+        mask.resize(static_cast<size_t>(R) * R);
+        for (int oy = 1; oy <= R; oy++) {
+            for (int ox = 1; ox <= R; ox++) {
+                float coverage = std::clamp(R + 0.5f - std::sqrt(float(ox*ox + oy*oy)), 0.0f, 1.0f);
+                mask[(oy - 1) * R + ox - 1] = static_cast<uint8_t>(std::lround(coverage * 255));
+            }
+        }
+    }
+    return it->second;
+}
+
+// Coverage of pixel (x, y) by a w x h rounded rect, InsideRounded with soft edges.
+inline uint8_t RoundedCoverage(int x, int y, int w, int h, int R, const std::vector<uint8_t> &mask) {
+    if (x < 0 || y < 0 || x >= w || y >= h) return 0;
+    if (R <= 0) return 255;
+
+    int ox = std::max({R - x, x - (w - 1 - R), 0});
+    int oy = std::max({R - y, y - (h - 1 - R), 0});
+    if (ox == 0 || oy == 0) return 255;
+    return mask[(oy - 1) * R + ox - 1];
+}
+
+inline dr4::Color ScaleAlpha(dr4::Color color, uint8_t coverage) {
+    color.a = static_cast<uint8_t>((color.a * coverage + 127) / 255);
+    return color;
+}
+
+inline dr4::Color LerpColor(dr4::Color from, dr4::Color to, uint8_t t) {
+    auto lerp = [t](uint8_t a, uint8_t b) { return static_cast<uint8_t>((a * (255 - t) + b * t + 127) / 255); };
+    return dr4::Color(lerp(from.r, to.r), lerp(from.g, to.g), lerp(from.b, to.b), lerp(from.a, to.a));
+}
+
+// A rounded rect with a border of `border` pixels, drawn row by row. Only the corners and
+// the border bands are shaded per pixel; the rest of a row is one span of a single color.
+struct RoundedShapeLayout {
+    int W, H;
+    int outerR, innerR, border;
+    int innerW, innerH;
+    bool hasInner;
+    int edge;   // width of the per pixel part at each end of a row
+    const std::vector<uint8_t> &outerMask;
+    const std::vector<uint8_t> &innerMask;
+
+    RoundedShapeLayout(int W, int H, int radius, int border)
+        : W(W), H(H),
+          outerR(std::max(0, radius)),
+          innerR(std::max(0, radius - border)),
+          border(border),
+          innerW(W - 2*border),
+          innerH(H - 2*border),
+          hasInner(innerW > 0 && innerH > 0),
+          edge(hasInner ? std::max(outerR, border + innerR) : outerR),
+          outerMask(GetRoundedCornerMask(outerR)),
+          innerMask(GetRoundedCornerMask(innerR))
+    {}
+
+    uint8_t Outer(int x, int y) const { return RoundedCoverage(x, y, W, H, outerR, outerMask); }
+    uint8_t Inner(int x, int y) const {
+        if (!hasInner) return 0;
+        return RoundedCoverage(x - border, y - border, innerW, innerH, innerR, innerMask);
+    }
+
+    // the middle span of row y lies inside the inner rect
+    bool MiddleIsInner(int y) const { return hasInner && y >= border && y < H - border; }
+
+    // pixel(x, y) for the per pixel parts of row y, span(x0, x1, y) for the middle one
+    template <typename Pixel, typename Span>
+    void ForEachRow(Pixel &&pixel, Span &&span) const {
+        int leftEnd    = std::min(edge, W);
+        int rightStart = std::max(W - edge, leftEnd);
+        for (int y = 0; y < H; ++y) {
+            for (int x = 0; x < leftEnd; ++x) pixel(x, y);
+            if (leftEnd < rightStart) span(leftEnd, rightStart, y);
+            for (int x = rightStart; x < W; ++x) pixel(x, y);
+        }
+    }
+};
+
+// Filled rounded rect with a border, edges anti-aliased. Corners outside the shape
+// are cleared to FULL_TRANSPARENT.
+template <typename PutPixel>
 inline void DrawBlenderRoundedRectangle(
         int W, int H,
         int radius,
         int border,
         dr4::Color bd,
         dr4::Color bg,
-        std::function<void(int,int,dr4::Color)> putPixel)
+        PutPixel &&putPixel)
 {
     if (W <= 0 || H <= 0) return;
-    int outerR = std::max(0, radius);
-    int innerW  = W - 2*border;
-    int innerH  = H - 2*border;
-    int innerR  = std::max(0, radius - border);
-    bool hasInner = (innerW > 0 && innerH > 0 && innerR >= 0);
-
-    for (int y = 0; y < H; ++y) {
-        for (int x = 0; x < W; ++x) {
-            if (!InsideRounded(x, y, W, H, outerR)) {
-                putPixel(x, y, FULL_TRANSPARENT);
-                continue;
-            }
+    RoundedShapeLayout shape(W, H, radius, std::max(0, border));
 
-            bool inInner = false;
-            if (hasInner) {
-                inInner = InsideRounded(x - border, y - border, innerW, innerH, innerR);
-            }
-
-            if (inInner) {
-                putPixel(x, y, bg);
-            } else {
-                putPixel(x, y, bd);
+    shape.ForEachRow(
+        [&](int x, int y) {
+            uint8_t outer = shape.Outer(x, y);
+            if (outer == 0) {
+                putPixel(x, y, FULL_TRANSPARENT);
+                return;
             }
+            // without a border the bg edge fades straight to transparent
+            dr4::Color color = (shape.border == 0 ? bg : LerpColor(bd, bg, shape.Inner(x, y)));
+            putPixel(x, y, (outer == 255 ? color : ScaleAlpha(color, outer)));
+        },
+        [&](int x0, int x1, int y) {
+            dr4::Color color = (shape.MiddleIsInner(y) ? bg : bd);
+            for (int x = x0; x < x1; ++x) putPixel(x, y, color);
         }
-    }
+    );
 }
 
+// Border of a rounded rect; pixels inside it are left untouched, so the inner edge
+// is not blended and only the outer one is anti-aliased.
+template <typename PutPixel>
 inline void DrawBlenderRoundedFrame(
         int W, int H,
         int radius,
         int border,
         dr4::Color bd,
-        std::function<void(int,int,dr4::Color)> putPixel)
+        PutPixel &&putPixel)
 {
     if (W <= 0 || H <= 0) return;
-    int outerR = std::max(0, radius);
-    int innerW  = W - 2*border;
-    int innerH  = H - 2*border;
-    int innerR  = std::max(0, radius - border);
-    bool hasInner = (innerW > 0 && innerH > 0 && innerR >= 0);
-
-    for (int y = 0; y < H; ++y) {
-        for (int x = 0; x < W; ++x) {
-            if (!InsideRounded(x, y, W, H, outerR)) {
-                putPixel(x, y, FULL_TRANSPARENT);
-                continue;
-            }
+    RoundedShapeLayout shape(W, H, radius, std::max(0, border));
 
-            bool inInner = false;
-            if (hasInner) {
-                inInner = InsideRounded(x - border, y - border, innerW, innerH, innerR);
-            }
-
-            if (inInner) {
-                continue;
-            } else {
-                putPixel(x, y, bd);
+    shape.ForEachRow(
+        [&](int x, int y) {
+            uint8_t outer = shape.Outer(x, y);
+            if (outer == 0) {
+                putPixel(x, y, FULL_TRANSPARENT);
+                return;
             }
+            if (shape.Inner(x, y) >= 128) return;
+            putPixel(x, y, (outer == 255 ? bd : ScaleAlpha(bd, outer)));
+        },
+        [&](int x0, int x1, int y) {
+            if (shape.MiddleIsInner(y)) return;
+            for (int x = x0; x < x1; ++x) putPixel(x, y, bd);
         }
-    }
+    );
 }
 
 
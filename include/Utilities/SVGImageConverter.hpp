@@ -1,7 +1,19 @@
 #pragma once
 #include <string>
+#include <vector>
 #include <functional>
 #include "dr4/math/color.hpp"
 #include "dr4/math/vec2.hpp"
 
-void ExtractSVG(const std::string &path, dr4::Vec2f pixelSize, std::function<void(int,int,dr4::Color)> putPixel);
\ No newline at end of file
+struct SVGRaster {
+    int width  = 0;
+    int height = 0;
+    std::vector<unsigned char> rgba; // width * height * 4, rows top to bottom
+};
+
+// Parses and rasterizes `path` at `pixelSize` once per process, later calls with the same
+// path and size return the cached raster. Icons baked into the build (see IconAtlas.hpp)
+// are only copied. The reference stays valid until exit.
+const SVGRaster &RasterizeSVG(const std::string &path, dr4::Vec2f pixelSize);
+
+void ExtractSVG(const std::string &path, dr4::Vec2f pixelSize, std::function<void(int,int,dr4::Color)> putPixel);
@@ -0,0 +1,42 @@
+#pragma once
+#include <atomic>
+#include <string>
+#include <thread>
+
+#include "Utilities/BinaryScene.hpp"
+
+namespace roa
+{
+
+// Converts a scene file between the text and binary formats on a background thread.
+// The UI thread polls GetState() like for SceneSaveTask.
+class SceneConvertTask {
+public:
+    enum class State {
+        CONVERTING,
+        DONE,
+        FAILED
+    };
+
+private:
+    std::atomic<State> state = State::CONVERTING;
+    std::jthread       worker;
+
+public:
+    SceneConvertTask(const std::string &srcPath, const std::string &dstPath):
+        worker([this, srcPath, dstPath]() {
+            bool ok = ConvertSceneFile(srcPath, dstPath);
+            state.store(ok ? State::DONE : State::FAILED, std::memory_order_release);
+        })
+    {}
+
+    // joins the worker
+    ~SceneConvertTask() = default;
+
+    SceneConvertTask(const SceneConvertTask&) = delete;
+    SceneConvertTask& operator=(const SceneConvertTask&) = delete;
+
+    State GetState() const { return state.load(std::memory_order_acquire); }
+};
+
+} // namespace roa
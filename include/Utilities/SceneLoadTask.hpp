@@ -0,0 +1,122 @@
+#pragma once
+#include <atomic>
+#include <deque>
+#include <filesystem>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "Utilities/BinaryScene.hpp"
+#include "Utilities/MeshImport.hpp"
+#include "Utilities/SceneParser.hpp"
+
+namespace roa
+{
+
+// File of a MESH record, imported once however many records place it.
+struct ImportedSceneMesh {
+    std::string                         path; // absolute, relative record paths are taken from the scene's directory
+    std::shared_ptr<const TriangleMesh> mesh; // nullptr if the import failed
+};
+
+// Imported files by absolute path.
+using SceneMeshCache = std::unordered_map<std::string, std::shared_ptr<const TriangleMesh>>;
+
+// One entry per ParsedScene::meshes. `cache`, if given, keeps files imported by earlier calls.
+inline std::vector<ImportedSceneMesh> ImportSceneMeshes(const ParsedScene &scene, const std::filesystem::path &sceneDir,
+                                                        SceneMeshCache *cache = nullptr)
+{
+    std::vector<ImportedSceneMesh> imported;
+    imported.reserve(scene.meshes.size());
+    SceneMeshCache local;
+    SceneMeshCache &byPath = (cache ? *cache : local);
+
+    for (const auto &sceneMesh : scene.meshes) {
+        std::error_code ec;
+        std::filesystem::path path = std::filesystem::absolute(sceneDir / sceneMesh.path, ec).lexically_normal();
+        ImportedSceneMesh &entry = imported.emplace_back();
+        entry.path = (ec ? std::string(sceneMesh.path) : path.string());
+
+        auto [it, inserted] = byPath.try_emplace(entry.path);
+        if (inserted) {
+            it->second = LoadTriangleMesh(entry.path);
+            if (!it->second) std::cerr << "ImportSceneMeshes : failed to import `" << entry.path << "`\n";
+        }
+        entry.mesh = it->second;
+    }
+    return imported;
+}
+
+// Reads and parses a scene file on a background thread, part by part, and imports the mesh
+// files each part names. The UI thread takes parts while later ones are still being parsed
+// and polls GetState() to learn when no more will come.
+class SceneLoadTask {
+public:
+    enum class State {
+        PARSING,
+        READY,
+        FAILED
+    };
+
+    // Line-aligned piece of a text scene, a binary scene arrives as one part.
+    struct Part {
+        ParsedScene                    scene;
+        std::vector<ImportedSceneMesh> meshes;   // one per scene.meshes
+        float                          progress; // share of the file read up to the end of this part
+    };
+
+private:
+    std::mutex                        partsMutex;
+    std::deque<std::unique_ptr<Part>> parts; // parsed and not taken yet
+    std::atomic<State>                state = State::PARSING;
+    std::jthread                      worker;
+
+public:
+    explicit SceneLoadTask(const std::string &path):
+        worker([this, path](std::stop_token stop) {
+            std::filesystem::path sceneDir = std::filesystem::path(path).parent_path();
+            SceneMeshCache meshCache;
+            auto publish = [&](ParsedScene &&scene, float progress) {
+                auto part = std::make_unique<Part>(std::move(scene), std::vector<ImportedSceneMesh>{}, progress);
+                part->meshes = ImportSceneMeshes(part->scene, sceneDir, &meshCache);
+                std::lock_guard lock(partsMutex);
+                parts.push_back(std::move(part));
+            };
+
+            bool ok = false;
+            if (IsBinaryScenePath(path)) {
+                ParsedScene scene;
+                ok = ReadBinaryScene(path, scene);
+                if (ok) publish(std::move(scene), 1);
+            } else {
+                ok = ParseSceneFileInParts(path, publish, stop);
+            }
+            state.store(ok ? State::READY : State::FAILED, std::memory_order_release);
+        })
+    {}
+
+    // Requests a stop and joins the worker. Text parsing stops at the next line, a mesh
+    // import or binary read in progress still completes.
+    ~SceneLoadTask() = default;
+
+    SceneLoadTask(const SceneLoadTask&) = delete;
+    SceneLoadTask& operator=(const SceneLoadTask&) = delete;
+
+    // Parts taken before the state leaves PARSING may be followed by more, afterwards they are all out.
+    State GetState() const { return state.load(std::memory_order_acquire); }
+
+    // The oldest part not taken yet, nullptr if there is none right now.
+    std::unique_ptr<Part> TakePart() {
+        std::lock_guard lock(partsMutex);
+        if (parts.empty()) return nullptr;
+        std::unique_ptr<Part> part = std::move(parts.front());
+        parts.pop_front();
+        return part;
+    }
+};
+
+} // namespace roa
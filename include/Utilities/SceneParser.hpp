@@ -0,0 +1,86 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <stop_token>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Utilities/BinaryScene.hpp"
+#include "RayTracerWidgets/RayVisibility.hpp"
+
+namespace roa
+{
+
+enum class SceneRecordType : uint8_t {
+    SPHERE,
+    PLANE,
+    CUBE,
+    POLYGON,
+    MESH,
+    LIGHT
+};
+
+inline constexpr uint32_t NO_SCENE_MATERIAL = UINT32_MAX;
+inline constexpr uint64_t NO_SCENE_GROUP    = 0;
+
+// One line of a text scene with the geometry already converted to numbers.
+// `record` is the material record of a primitive (what RTMaterialManager::deserializeMaterial
+// reads) or everything after `Light` for a light; it points into ParsedScene::text.
+// Primitives read from a binary scene have no material text, `material` indexes
+// ParsedScene::materials instead.
+// Records with the same `group` are instances sharing geometry and material, written as a
+// trailing `Group <id>` field after the optional `Visibility <mask>`.
+struct SceneRecord {
+    SceneRecordType  type        = SceneRecordType::SPHERE;
+    uint8_t          visibility  = RAY_VISIBILITY_ALL;
+    float            position[3] = {};
+    float            params[3]   = {}; // radius / plane normal / cube half size
+    uint32_t         firstVertex = 0;  // index into ParsedScene::meshes for a MESH record
+    uint32_t         vertexCount = 0;
+    uint32_t         material    = NO_SCENE_MATERIAL;
+    uint64_t         group       = NO_SCENE_GROUP;
+    std::string_view record;
+};
+
+// A mesh is stored as the file it was imported from, placed by a row-major 3x4 transform:
+//   Mesh <12 toWorld values> <path length> <path> <material record>
+struct SceneMesh {
+    float            toWorld[12] = {1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0};
+    std::string_view path; // points into ParsedScene::text
+};
+
+// Record and path views point into `text`: a scene can be moved, copying it is disabled
+// because the copy's views would still point into the original.
+struct ParsedScene {
+    ParsedScene() = default;
+    ParsedScene(ParsedScene &&) = default;
+    ParsedScene &operator=(ParsedScene &&) = default;
+    ParsedScene(const ParsedScene &) = delete;
+    ParsedScene &operator=(const ParsedScene &) = delete;
+
+    std::vector<char>           text;
+    std::vector<SceneRecord>    records;     // in file order
+    std::vector<BinaryVertex>   vertices;
+    std::vector<BinaryMaterial> materials;
+    std::vector<SceneMesh>      meshes;
+    size_t                      skippedLines = 0;
+};
+
+inline constexpr size_t SCENE_PART_SIZE = 4 * 1024 * 1024;
+
+// Splits the text into line-aligned chunks, parses them in parallel with std::from_chars
+// and merges the results in file order. threadCount == 0 picks it from the text size.
+// Once `stop` is requested the chunks end early and the scene is left incomplete.
+void ParseSceneText(std::vector<char> text, ParsedScene &scene, size_t threadCount = 0, std::stop_token stop = {});
+
+bool ParseSceneFile(const std::string &path, ParsedScene &scene, size_t threadCount = 0);
+
+// Reads the file in line-aligned parts of about `partSize` bytes and hands each to `onPart` as
+// a scene of its own, together with the share of the file read so far, before reading the next.
+// Returns false if the file could not be read; a requested stop just ends the parts early.
+bool ParseSceneFileInParts(const std::string &path, const std::function<void(ParsedScene &&part, float progress)> &onPart,
+                           std::stop_token stop = {}, size_t partSize = SCENE_PART_SIZE);
+
+} // namespace roa
@@ -0,0 +1,44 @@
+#pragma once
+#include <atomic>
+#include <string>
+#include <thread>
+
+#include "Utilities/SceneWriter.hpp"
+
+namespace roa
+{
+
+// Formats and writes a scene snapshot on a background thread.
+// The snapshot is owned by the task, so the editor keeps working on the live scene meanwhile.
+class SceneSaveTask {
+public:
+    enum class State {
+        WRITING,
+        DONE,
+        FAILED
+    };
+
+private:
+    ParsedScene        snapshot;
+    std::atomic<State> state = State::WRITING;
+    std::jthread       worker;
+
+public:
+    SceneSaveTask(const std::string &path, ParsedScene snapshot_):
+        snapshot(std::move(snapshot_)),
+        worker([this, path]() {
+            bool ok = WriteSceneFile(path, snapshot);
+            state.store(ok ? State::DONE : State::FAILED, std::memory_order_release);
+        })
+    {}
+
+    // joins the worker
+    ~SceneSaveTask() = default;
+
+    SceneSaveTask(const SceneSaveTask&) = delete;
+    SceneSaveTask& operator=(const SceneSaveTask&) = delete;
+
+    State GetState() const { return state.load(std::memory_order_acquire); }
+};
+
+} // namespace roa
@@ -0,0 +1,85 @@
+#pragma once
+#include <algorithm>
+#include <functional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "Utilities/SceneParser.hpp"
+
+namespace roa
+{
+
+// Assembles a ParsedScene record by record, e.g. as a snapshot of the editor scene.
+// Record and path views are pointed into the text buffer by Finish(), once it stops growing.
+class ParsedSceneBuilder {
+public:
+    using TextRange = std::pair<size_t, size_t>; // offset, length in the scene text
+
+private:
+    ParsedScene scene;
+    std::vector<TextRange> recordRanges;
+    std::vector<TextRange> pathRanges; // of scene.meshes
+
+public:
+    SceneRecord &Add(SceneRecordType type, std::string_view record) { return Add(type, AddText(record)); }
+
+    // Records may share text added once, e.g. the material record of many primitives.
+    SceneRecord &Add(SceneRecordType type, TextRange record) {
+        recordRanges.push_back(record);
+
+        SceneRecord &added = scene.records.emplace_back();
+        added.type = type;
+        return added;
+    }
+
+    TextRange AddText(std::string_view text) {
+        TextRange range(scene.text.size(), text.size());
+        scene.text.insert(scene.text.end(), text.begin(), text.end());
+        return range;
+    }
+
+    // Index of the added mesh, for SceneRecord::firstVertex of its MESH record.
+    uint32_t AddMesh(std::span<const float, 12> toWorld, std::string_view path) {
+        pathRanges.push_back(AddText(path));
+        SceneMesh &mesh = scene.meshes.emplace_back();
+        std::copy(toWorld.begin(), toWorld.end(), mesh.toWorld);
+        return static_cast<uint32_t>(scene.meshes.size() - 1);
+    }
+
+    void AddVertex(float x, float y, float z) { scene.vertices.push_back({{x, y, z}}); }
+    uint32_t GetVertexCount() const { return static_cast<uint32_t>(scene.vertices.size()); }
+
+    ParsedScene Finish() {
+        auto view = [this](TextRange range) { return std::string_view(scene.text.data() + range.first, range.second); };
+        for (size_t i = 0; i < scene.records.size(); i++) scene.records[i].record = view(recordRanges[i]);
+        for (size_t i = 0; i < scene.meshes.size(); i++)  scene.meshes[i].path    = view(pathRanges[i]);
+        recordRanges.clear();
+        pathRanges.clear();
+        return std::move(scene);
+    }
+};
+
+// Writes records in the text grammar read by ParseSceneText, floats are formatted with std::to_chars.
+void FormatSceneText(const ParsedScene &scene, std::vector<char> &out);
+
+// A material stored as numbers, in the text grammar RTMaterialManager::deserializeMaterial reads.
+void FormatSceneMaterial(const BinaryMaterial &material, std::vector<char> &out);
+
+// One line of FormatSceneText without the trailing newline.
+void FormatSceneRecord(const ParsedScene &scene, const SceneRecord &record, std::vector<char> &out);
+
+// Writes through `write` into a temporary file next to `path`, then renames it over `path`,
+// so readers see either the old file or the complete new one. `write` has to fsync the
+// file before returning, otherwise a crash can still leave the renamed file incomplete.
+bool WriteFileAtomically(const std::string &path, const std::function<bool(const std::string &tmpPath)> &write);
+
+// write(2) until all of `data` is out, false on the first failed call.
+bool WriteAll(int fd, std::span<const char> data);
+
+// Text or binary format is picked by extension.
+bool WriteSceneFile(const std::string &path, const ParsedScene &scene);
+
+} // namespace roa
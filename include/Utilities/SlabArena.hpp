@@ -0,0 +1,143 @@
+#pragma once
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace roa
+{
+
+// Index of a slot plus the generation it was handed out at. A handle whose slot
+// has since been destroyed (and maybe reused) no longer resolves.
+struct SlabHandle {
+    uint32_t index      = UINT32_MAX;
+    uint32_t generation = 0;
+
+    bool IsNull() const { return index == UINT32_MAX; }
+    bool operator==(const SlabHandle &other) const = default;
+};
+
+// Objects of one type stored in fixed size slabs. Slots of destroyed objects are
+// reused before a new slab is allocated and slabs never move, so pointers stay
+// valid until the object is destroyed and live objects sit close together.
+template <typename T, size_t SLAB_SIZE = 256>
+class SlabArena {
+    struct Slot {
+        alignas(T) std::byte storage[sizeof(T)]; // first, so a T* is also its Slot*
+        uint32_t generation = 0;
+        uint32_t nextFree   = UINT32_MAX;
+        bool     alive      = false;
+    };
+
+    std::vector<std::unique_ptr<Slot[]>>   slabs;
+    std::map<const std::byte *, uint32_t> slabByAddress; // slab start -> slab index
+    uint32_t slotCount = 0;         // slots ever handed out
+    uint32_t freeList  = UINT32_MAX;
+    size_t   size      = 0;
+
+public:
+    SlabArena() = default;
+    ~SlabArena() { Clear(); }
+
+    SlabArena(const SlabArena&) = delete;
+    SlabArena& operator=(const SlabArena&) = delete;
+
+    template <typename... Args>
+    T *Create(Args&&... args) {
+        uint32_t index = freeList;
+        if (index != UINT32_MAX) {
+            freeList = slot(index).nextFree;
+        } else {
+            if (slotCount == slabs.size() * SLAB_SIZE) {
+                slabs.push_back(std::make_unique<Slot[]>(SLAB_SIZE));
+                slabByAddress.emplace(reinterpret_cast<const std::byte *>(slabs.back().get()), static_cast<uint32_t>(slabs.size() - 1));
+            }
+            index = slotCount++;
+        }
+
+        Slot &s = slot(index);
+        T *object = ::new (s.storage) T(std::forward<Args>(args)...);
+        s.alive = true;
+        size++;
+        return object;
+    }
+
+    void Destroy(T *object) {
+        uint32_t index = indexOf(object);
+        assert(index != UINT32_MAX);
+        Slot &s = slot(index);
+        assert(s.alive);
+
+        std::destroy_at(object);
+        s.alive = false;
+        s.generation++;
+        s.nextFree = freeList;
+        freeList = index;
+        size--;
+    }
+
+    bool Contains(const T *object) const { return indexOf(object) != UINT32_MAX; }
+
+    SlabHandle GetHandle(const T *object) const {
+        uint32_t index = indexOf(object);
+        if (index == UINT32_MAX) return {};
+        return {index, slot(index).generation};
+    }
+
+    // nullptr for a null or stale handle
+    T *Get(SlabHandle handle) const {
+        if (handle.index >= slotCount) return nullptr;
+        const Slot &s = slot(handle.index);
+        if (!s.alive || s.generation != handle.generation) return nullptr;
+        return std::launder(reinterpret_cast<T *>(const_cast<std::byte *>(s.storage)));
+    }
+
+    // Live objects in slot order.
+    template <typename F>
+    void ForEach(F &&f) const {
+        for (uint32_t i = 0; i < slotCount; i++) {
+            const Slot &s = slot(i);
+            if (s.alive) f(std::launder(reinterpret_cast<T *>(const_cast<std::byte *>(s.storage))));
+        }
+    }
+
+    // Destroys every object, the slabs are kept for reuse.
+    void Clear() {
+        freeList = UINT32_MAX;
+        for (uint32_t i = slotCount; i-- > 0;) {
+            Slot &s = slot(i);
+            if (s.alive) {
+                std::destroy_at(std::launder(reinterpret_cast<T *>(s.storage)));
+                s.alive = false;
+                s.generation++;
+            }
+            s.nextFree = freeList;
+            freeList = i;
+        }
+        size = 0;
+    }
+
+    size_t GetSize() const { return size; }
+
+private:
+    Slot &slot(uint32_t index) { return slabs[index / SLAB_SIZE][index % SLAB_SIZE]; }
+    const Slot &slot(uint32_t index) const { return slabs[index / SLAB_SIZE][index % SLAB_SIZE]; }
+
+    uint32_t indexOf(const T *object) const {
+        auto address = reinterpret_cast<const std::byte *>(object);
+        auto it = slabByAddress.upper_bound(address);
+        if (it == slabByAddress.begin()) return UINT32_MAX;
+        --it;
+
+        size_t offset = static_cast<size_t>(address - it->first);
+        if (offset >= SLAB_SIZE * sizeof(Slot)) return UINT32_MAX;
+        assert(offset % sizeof(Slot) == 0);
+        return static_cast<uint32_t>(it->second * SLAB_SIZE + offset / sizeof(Slot));
+    }
+};
+
+} // namespace roa
@@ -0,0 +1,81 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+
+#include "Utilities/TriangleMesh.hpp"
+
+namespace roa
+{
+
+// Affine transform p' = M * p + t, stored as a row-major 3x4 matrix.
+struct Transform {
+    float m[3][4] = {{1, 0, 0, 0}, {0, 1, 0, 0}, {0, 0, 1, 0}};
+
+    static Transform Translation(float x, float y, float z) {
+        Transform transform;
+        transform.m[0][3] = x;
+        transform.m[1][3] = y;
+        transform.m[2][3] = z;
+        return transform;
+    }
+
+    bool IsIdentity() const {
+        static const Transform identity;
+        return std::equal(&m[0][0], &m[0][0] + 12, &identity.m[0][0]);
+    }
+
+    void ApplyToPoint(const float (&p)[3], float (&out)[3]) const {
+        for (int row = 0; row < 3; row++) {
+            out[row] = m[row][0] * p[0] + m[row][1] * p[1] + m[row][2] * p[2] + m[row][3];
+        }
+    }
+
+    void ApplyToVector(const float (&v)[3], float (&out)[3]) const {
+        for (int row = 0; row < 3; row++) {
+            out[row] = m[row][0] * v[0] + m[row][1] * v[1] + m[row][2] * v[2];
+        }
+    }
+
+    // Box around the transformed corners of `bounds`.
+    MeshBounds ApplyToBounds(const MeshBounds &bounds) const {
+        MeshBounds result = {{INFINITY, INFINITY, INFINITY}, {-INFINITY, -INFINITY, -INFINITY}};
+        for (int corner = 0; corner < 8; corner++) {
+            const float p[3] = {
+                (corner & 1 ? bounds.max[0] : bounds.min[0]),
+                (corner & 2 ? bounds.max[1] : bounds.min[1]),
+                (corner & 4 ? bounds.max[2] : bounds.min[2])
+            };
+            float q[3];
+            ApplyToPoint(p, q);
+            for (int axis = 0; axis < 3; axis++) {
+                result.min[axis] = std::min(result.min[axis], q[axis]);
+                result.max[axis] = std::max(result.max[axis], q[axis]);
+            }
+        }
+        return result;
+    }
+
+    // Inverse of an invertible transform; a singular one gives the identity.
+    Transform Inverse() const {
+        float a = m[0][0], b = m[0][1], c = m[0][2];
+        float d = m[1][0], e = m[1][1], f = m[1][2];
+        float g = m[2][0], h = m[2][1], i = m[2][2];
+
+        float det = a * (e * i - f * h) - b * (d * i - f * g) + c * (d * h - e * g);
+        if (std::fabs(det) < 1e-12f) return {};
+        float inv = 1 / det;
+
+        Transform result;
+        result.m[0][0] = (e * i - f * h) * inv; result.m[0][1] = (c * h - b * i) * inv; result.m[0][2] = (b * f - c * e) * inv;
+        result.m[1][0] = (f * g - d * i) * inv; result.m[1][1] = (a * i - c * g) * inv; result.m[1][2] = (c * d - a * f) * inv;
+        result.m[2][0] = (d * h - e * g) * inv; result.m[2][1] = (b * g - a * h) * inv; result.m[2][2] = (a * e - b * d) * inv;
+
+        const float t[3] = {m[0][3], m[1][3], m[2][3]};
+        float rt[3];
+        result.ApplyToVector(t, rt);
+        for (int row = 0; row < 3; row++) result.m[row][3] = -rt[row];
+        return result;
+    }
+};
+
+} // namespace roa
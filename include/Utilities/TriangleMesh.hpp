@@ -0,0 +1,71 @@
+#pragma once
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace roa
+{
+
+struct MeshVertex {
+    float position[3];
+};
+
+struct MeshBounds {
+    float min[3];
+    float max[3];
+};
+
+// Indexed triangle mesh: one shared vertex buffer, three indices per triangle
+// and a BVH over the triangles. The build reorders triangles so that every
+// leaf covers a contiguous range of the index buffer.
+class TriangleMesh {
+public:
+    static constexpr uint32_t MAX_LEAF_TRIANGLES = 4;
+    static constexpr int      SAH_BINS           = 12;
+    // below this depth only median splits are made, at most 32 more levels for 2^32 triangles
+    static constexpr int      MEDIAN_SPLIT_DEPTH = 30;
+    static constexpr int      MAX_DEPTH          = MEDIAN_SPLIT_DEPTH + 32;
+
+    // 32 bytes, two nodes share a cache line. Inner nodes have count == 0 and
+    // their children at `first` and `first + 1`, leaves own triangles [first, first + count).
+    struct BVHNode {
+        float    min[3];
+        uint32_t first;
+        float    max[3];
+        uint32_t count;
+    };
+
+    struct Hit {
+        float    t;
+        uint32_t triangle;
+    };
+
+private:
+    std::vector<MeshVertex> vertices;
+    std::vector<uint32_t>   indices;
+    std::vector<BVHNode>    nodes;
+
+public:
+    // Triangles referencing vertices out of range are dropped.
+    TriangleMesh(std::vector<MeshVertex> vertices, std::vector<uint32_t> indices);
+
+    std::span<const MeshVertex> GetVertices() const { return vertices; }
+    std::span<const uint32_t>   GetIndices()  const { return indices;  }
+    std::span<const BVHNode>    GetNodes()    const { return nodes;    }
+
+    size_t GetTriangleCount() const { return indices.size() / 3; }
+    bool   Empty() const { return indices.empty(); }
+
+    // Object space bounds; all zero for an empty mesh.
+    MeshBounds GetBounds() const;
+
+    // Nearest hit with 0 < t < tMax.
+    std::optional<Hit> Intersect(const float (&origin)[3], const float (&direction)[3],
+                                 float tMax = 3.4e38f) const;
+
+private:
+    void buildBVH();
+};
+
+} // namespace roa
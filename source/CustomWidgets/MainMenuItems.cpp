@@ -1,11 +1,13 @@
 #include <cassert>
 #include <filesystem>
 #include <memory>
+#include <sstream>
 
 #include "BasicWidgets/TextWindow.hpp"
 #include "CompositeWidgets/EditorWidget.hpp"
 #include "CustomWidgets/OpticDesktop.hpp"
 #include "CustomWidgets/MainMenuItems.hpp"
+#include "Utilities/MeshImport.hpp"
 
 namespace roa
 {
@@ -78,7 +80,7 @@ FileItem::FileItem(Desktop *desktop, EditorWidget *editor)
     auto fileDropDownMenu =
         std::make_unique<Outliner<int *>>(desktop->GetUI());
 
-    fileDropDownMenu->SetSize({70, 40});
+    fileDropDownMenu->SetSize({70, 80});
     fileDropDownMenu->SetRecordIconStartPos({5, 3});
     fileDropDownMenu->SetRecordIconSize({14, 14});
     fileDropDownMenu->SetBGColor(desktop->BGColor);
@@ -106,16 +108,33 @@ FileItem::FileItem(Desktop *desktop, EditorWidget *editor)
                             "Provide filename",
                             {200,120,0,255}
                         );
-                    } else if (editor->SerializeScene(filename)) {
+                    } else if (editor->IsSavingScene()) {
                         window->DisplayMessage(
-                            "Scene is saved",
-                            {0,200,0,255}
+                            "Previous save is running",
+                            {200,120,0,255}
                         );
                     } else {
-                        window->DisplayMessage(
-                            "serialization failed",
-                            {200,0,0,255}
+                        editor->SaveSceneAsync(
+                            filename,
+                            [window](bool success) {
+                                window->SetOnCloseAction(nullptr);
+                                if (success) {
+                                    window->DisplayMessage(
+                                        "Scene is saved",
+                                        {0,200,0,255}
+                                    );
+                                } else {
+                                    window->DisplayMessage(
+                                        "serialization failed",
+                                        {200,0,0,255}
+                                    );
+                                }
+                            }
                         );
+                        window->DisplayMessage("Saving scene...");
+                        window->SetOnCloseAction([editor]() {
+                            editor->DropSceneSaveCallback();
+                        });
                     }
                 }
             );
@@ -148,16 +167,166 @@ FileItem::FileItem(Desktop *desktop, EditorWidget *editor)
                             "Scene file is not found",
                             {200,0,0,255}
                         );
-                    } else if (editor->DeserializeScene(filename)) {
+                    } else if (editor->IsLoadingScene()) {
                         window->DisplayMessage(
-                            "Scene loaded successfully!",
-                            {0,200,0,255}
+                            "Another scene is loading",
+                            {200,120,0,255}
+                        );
+                    } else {
+                        editor->LoadSceneAsync(
+                            filename,
+                            [window](float progress) {
+                                window->SetProgress(progress);
+                            },
+                            [window](bool success) {
+                                window->SetOnCloseAction(nullptr);
+                                window->HideProgress();
+                                if (success) {
+                                    window->DisplayMessage(
+                                        "Scene loaded successfully!",
+                                        {0,200,0,255}
+                                    );
+                                } else {
+                                    window->DisplayMessage(
+                                        "Scene loading failed!",
+                                        {200,0,0,255}
+                                    );
+                                }
+                            }
+                        );
+                        window->DisplayMessage("Loading scene...");
+                        // closing the window stops the load, whatever arrived stays
+                        window->SetOnCloseAction([editor]() {
+                            editor->CancelSceneLoad();
+                        });
+                    }
+                }
+            );
+        }
+    );
+
+    AddDropdownRecord(
+        fileDropDownMenu.get(),
+        "Convert",
+        static_cast<UI *>(desktop->GetUI())
+            ->GetTexturePack().fileSaveIconPath,
+        [desktop, editor]() {
+            OpenCenteredTextWindow(
+                desktop,
+                "Convert scene: <src> <dst>",
+                "Convert",
+                "Cancel",
+                [editor](TextWindow *window,
+                         const std::string &input)
+                {
+                    namespace fs = std::filesystem;
+
+                    std::istringstream iss(input);
+                    std::string src, dst;
+                    iss >> src >> dst;
+
+                    if (src.empty() || dst.empty()) {
+                        window->DisplayMessage(
+                            "Provide source and destination",
+                            {200,120,0,255}
+                        );
+                    } else if (!fs::exists(src)) {
+                        window->DisplayMessage(
+                            "Scene file is not found",
+                            {200,0,0,255}
+                        );
+                    } else if (editor->IsConvertingScene()) {
+                        window->DisplayMessage(
+                            "Previous conversion is running",
+                            {200,120,0,255}
                         );
                     } else {
+                        editor->ConvertSceneAsync(
+                            src,
+                            dst,
+                            [window](bool success) {
+                                window->SetOnCloseAction(nullptr);
+                                if (success) {
+                                    window->DisplayMessage(
+                                        "Scene converted",
+                                        {0,200,0,255}
+                                    );
+                                } else {
+                                    window->DisplayMessage(
+                                        "conversion failed",
+                                        {200,0,0,255}
+                                    );
+                                }
+                            }
+                        );
+                        window->DisplayMessage("Converting scene...");
+                        window->SetOnCloseAction([editor]() {
+                            editor->DropSceneConvertCallback();
+                        });
+                    }
+                }
+            );
+        }
+    );
+
+    AddDropdownRecord(
+        fileDropDownMenu.get(),
+        "Import",
+        static_cast<UI *>(desktop->GetUI())
+            ->GetTexturePack().outlinerObMeshSvgPath,
+        [desktop, editor]() {
+            OpenCenteredTextWindow(
+                desktop,
+                "Import mesh (.obj, .ply)",
+                "Import",
+                "Cancel",
+                [editor](TextWindow *window,
+                         const std::string &filename)
+                {
+                    namespace fs = std::filesystem;
+
+                    if (filename.empty()) {
                         window->DisplayMessage(
-                            "Scene loading failed!",
+                            "Provide filename",
+                            {200,120,0,255}
+                        );
+                    } else if (!IsMeshPath(filename)) {
+                        window->DisplayMessage(
+                            "Only .obj and .ply are supported",
+                            {200,120,0,255}
+                        );
+                    } else if (!fs::exists(filename)) {
+                        window->DisplayMessage(
+                            "Mesh file is not found",
                             {200,0,0,255}
                         );
+                    } else if (editor->IsImportingMesh()) {
+                        window->DisplayMessage(
+                            "Another mesh is importing",
+                            {200,120,0,255}
+                        );
+                    } else {
+                        editor->ImportMeshAsync(
+                            filename,
+                            [window](bool success) {
+                                window->SetOnCloseAction(nullptr);
+                                if (success) {
+                                    window->DisplayMessage(
+                                        "Mesh imported",
+                                        {0,200,0,255}
+                                    );
+                                } else {
+                                    window->DisplayMessage(
+                                        "Mesh import failed",
+                                        {200,0,0,255}
+                                    );
+                                }
+                            }
+                        );
+                        window->DisplayMessage("Importing mesh...");
+                        window->SetOnCloseAction([editor]() {
+                            editor->CancelMeshImport();
+                        });
                     }
                 }
             );
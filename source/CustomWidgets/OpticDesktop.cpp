@@ -17,6 +17,7 @@ OpticDesktop::OpticDesktop(hui::UI *ui, cum::Manager *pluginManager_)
 
     auto editor = std::make_unique<roa::EditorWidget>(ui);
     editor->SetSize(GetSize());
+    editor->EnableAutosave(AUTOSAVE_JOURNAL_PATH);
 
     auto fileItem = std::make_unique<FileItem>(this, editor.get());
     AddMaiMenuItem(std::move(fileItem));
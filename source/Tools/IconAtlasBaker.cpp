@@ -0,0 +1,122 @@
+// Build step of OpticApplication2: rasterizes the icons listed in a manifest and writes
+// them as a C++ source with one pixel blob, see Utilities/IconAtlas.hpp.
+//
+// usage: IconAtlasBaker <manifest> <source dir> <output.cpp>
+
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#define NANOSVG_IMPLEMENTATION
+#include "Utilities/nanosvg.h"
+
+#define NANOSVGRAST_IMPLEMENTATION
+#include "Utilities/nanosvgrast.h"
+
+struct IconEntry {
+    std::string path;
+    int         width  = 0;
+    int         height = 0;
+    size_t      offset = 0;
+};
+
+static bool readManifest(const std::string &manifestPath, std::vector<IconEntry> &entries) {
+    std::ifstream manifest(manifestPath);
+    if (!manifest) {
+        std::cerr << "IconAtlasBaker : can't open manifest `" << manifestPath << "`\n";
+        return false;
+    }
+
+    std::string line;
+    for (int lineNumber = 1; std::getline(manifest, line); lineNumber++) {
+        if (line.empty() || line[0] == '#') continue;
+
+        std::istringstream stream(line);
+        IconEntry entry;
+        if (!(stream >> entry.path)) continue;
+        if (!(stream >> entry.width >> entry.height) || entry.width <= 0 || entry.height <= 0) {
+            std::cerr << "IconAtlasBaker : " << manifestPath << ":" << lineNumber << " expected `path width height`\n";
+            return false;
+        }
+        entries.push_back(entry);
+    }
+    return true;
+}
+
+// Same rasterization as ExtractSVG, so baked and runtime icons are identical.
+static bool rasterize(const std::string &file, int w, int h, std::vector<unsigned char> &pixels) {
+    NSVGimage *img = nsvgParseFromFile(file.c_str(), "px", 96);
+    if (img == nullptr) {
+        std::cerr << "IconAtlasBaker : nsvgParseFromFile `" << file << "` failed\n";
+        return false;
+    }
+
+    NSVGrasterizer *rast = nsvgCreateRasterizer();
+    if (rast == nullptr) {
+        nsvgDelete(img);
+        std::cerr << "IconAtlasBaker : nsvgCreateRasterizer failed\n";
+        return false;
+    }
+
+    size_t offset = pixels.size();
+    pixels.resize(offset + static_cast<size_t>(w) * h * 4);
+
+    float scale = (float)w / img->width;
+    nsvgRasterize(rast, img, 0, 0, scale, pixels.data() + offset, w, h, w * 4);
+
+    nsvgDeleteRasterizer(rast);
+    nsvgDelete(img);
+    return true;
+}
+
+static bool writeSource(const std::string &outputPath, const std::vector<IconEntry> &entries,
+                        const std::vector<unsigned char> &pixels)
+{
+    std::ofstream out(outputPath);
+    if (!out) {
+        std::cerr << "IconAtlasBaker : can't open output `" << outputPath << "`\n";
+        return false;
+    }
+
+    out << "// Generated by IconAtlasBaker, do not edit.\n"
+        << "#include \"Utilities/IconAtlas.hpp\"\n\n";
+
+    // a zero sized array is not valid C++, an empty atlas still gets one byte
+    out << "extern const unsigned char BAKED_ICON_PIXELS[] = {";
+    for (size_t i = 0; i < pixels.size(); i++) {
+        if (i % 16 == 0) out << "\n   ";
+        out << " " << static_cast<int>(pixels[i]) << ",";
+    }
+    if (pixels.empty()) out << " 0";
+    out << "\n};\n\n";
+
+    out << "extern const BakedIcon BAKED_ICONS[] = {\n";
+    for (const auto &entry : entries) {
+        out << "    {\"" << entry.path << "\", " << entry.width << ", " << entry.height << ", " << entry.offset << "},\n";
+    }
+    if (entries.empty()) out << "    {\"\", 0, 0, 0},\n";
+    out << "};\n\n";
+
+    out << "extern const size_t BAKED_ICON_COUNT = " << entries.size() << ";\n";
+    return static_cast<bool>(out);
+}
+
+int main(int argc, const char *argv[]) {
+    if (argc != 4) {
+        std::cerr << "usage: IconAtlasBaker <manifest> <source dir> <output.cpp>\n";
+        return 1;
+    }
+
+    std::vector<IconEntry> entries;
+    if (!readManifest(argv[1], entries)) return 1;
+
+    std::vector<unsigned char> pixels;
+    for (auto &entry : entries) {
+        entry.offset = pixels.size();
+        if (!rasterize(std::string(argv[2]) + "/" + entry.path, entry.width, entry.height, pixels)) return 1;
+    }
+
+    return writeSource(argv[3], entries, pixels) ? 0 : 1;
+}
@@ -0,0 +1,375 @@
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "Utilities/BinaryScene.hpp"
+#include "Utilities/SceneParser.hpp"
+#include "Utilities/SceneWriter.hpp"
+
+namespace roa
+{
+
+// ---------------- BinarySceneData ----------------
+
+BinaryStringRef BinarySceneData::AddString(std::string_view str) {
+    BinaryStringRef ref = {static_cast<uint32_t>(strings.size()), static_cast<uint32_t>(str.size())};
+    strings.append(str);
+    return ref;
+}
+
+uint32_t BinarySceneData::AddMaterial(const BinaryMaterial &material) {
+    std::string key(reinterpret_cast<const char *>(&material), sizeof(material));
+    auto [it, inserted] = materialIndices.try_emplace(std::move(key), static_cast<uint32_t>(materials.size()));
+    if (inserted) materials.push_back(material);
+    return it->second;
+}
+
+void BinarySceneData::AddLight(std::string_view record) {
+    lights.push_back({AddString(record)});
+}
+
+bool ParseBinaryMaterial(std::string_view record, BinaryMaterial &material) {
+    material = {};
+    const char *cur = record.data();
+    const char *end = cur + record.size();
+    auto skipSpaces = [&cur, end]() { while (cur < end && std::isspace(static_cast<unsigned char>(*cur))) cur++; };
+
+    skipSpaces();
+    const char *type = cur;
+    while (cur < end && !std::isspace(static_cast<unsigned char>(*cur))) cur++;
+    size_t typeSize = static_cast<size_t>(cur - type);
+    if (typeSize == 0 || typeSize >= BINARY_MATERIAL_TYPE_SIZE) return false;
+    std::memcpy(material.type, type, typeSize);
+
+    for (skipSpaces(); cur < end; skipSpaces()) {
+        if (material.paramCount == BINARY_MATERIAL_MAX_PARAMS) return false;
+        if (*cur == '+') cur++;
+        auto [ptr, ec] = std::from_chars(cur, end, material.params[material.paramCount]);
+        if (ec != std::errc()) return false;
+        material.paramCount++;
+        cur = ptr;
+    }
+    return true;
+}
+
+// ---------------- reading ----------------
+
+namespace
+{
+
+bool readAt(int fd, uint64_t offset, void *data, size_t size) {
+    char *out = static_cast<char *>(data);
+    while (size > 0) {
+        ssize_t got = ::pread(fd, out, size, static_cast<off_t>(offset));
+        if (got <= 0) return false;
+        out += got;
+        offset += static_cast<uint64_t>(got);
+        size -= static_cast<size_t>(got);
+    }
+    return true;
+}
+
+bool validHeader(const BinarySceneHeader &header, uint64_t fileSize) {
+    if (std::memcmp(header.magic, BINARY_SCENE_MAGIC, sizeof(BINARY_SCENE_MAGIC)) != 0) return false;
+    if (header.version != BINARY_SCENE_VERSION) return false;
+    if (header.sectionCount != BINARY_SCENE_SECTION_COUNT) return false;
+
+    const size_t elementSizes[BINARY_SCENE_SECTION_COUNT] = {
+        sizeof(BinaryMaterial), sizeof(BinarySphere), sizeof(BinaryPlane), sizeof(BinaryCube),
+        sizeof(BinaryPolygon), sizeof(BinaryVertex), sizeof(BinaryLight), sizeof(char), sizeof(uint8_t),
+        sizeof(BinaryMesh), sizeof(BinaryGroupMember)
+    };
+
+    for (size_t i = 0; i < BINARY_SCENE_SECTION_COUNT; i++) {
+        const BinarySectionEntry &entry = header.sections[i];
+        if (entry.offset % SECTION_ALIGNMENT != 0) return false;
+        if (entry.offset > fileSize) return false;
+        if (entry.count > (fileSize - entry.offset) / elementSizes[i]) return false;
+    }
+    return true;
+}
+
+// Reads one section into `out`, which is resized to the section's element count.
+template <typename T>
+bool readSection(int fd, const BinarySceneHeader &header, BinarySceneSection id, T &out) {
+    const BinarySectionEntry &entry = header.sections[static_cast<size_t>(id)];
+    out.resize(static_cast<size_t>(entry.count));
+    return readAt(fd, entry.offset, out.data(), out.size() * sizeof(out[0]));
+}
+
+} // namespace
+
+// ---------------- writing ----------------
+
+namespace
+{
+
+// Sections are written in order, `offset` tracks the file position.
+template <typename T>
+bool writeSection(int fd, uint64_t &offset, BinarySceneHeader &header, BinarySceneSection id, const T *data, size_t count) {
+    static const char padding[SECTION_ALIGNMENT] = {};
+
+    uint64_t aligned = (offset + SECTION_ALIGNMENT - 1) / SECTION_ALIGNMENT * SECTION_ALIGNMENT;
+    if (!WriteAll(fd, {padding, static_cast<size_t>(aligned - offset)})) return false;
+
+    header.sections[static_cast<size_t>(id)] = {aligned, count};
+    size_t bytes = count * sizeof(T);
+    offset = aligned + bytes;
+    return WriteAll(fd, {reinterpret_cast<const char *>(data), bytes});
+}
+
+} // namespace
+
+// Written through the fd and fsynced like text scenes, WriteFileAtomically relies on it.
+bool WriteBinaryScene(const std::string &path, const BinarySceneData &data) {
+    int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) return false;
+
+    BinarySceneHeader header = {};
+    std::memcpy(header.magic, BINARY_SCENE_MAGIC, sizeof(BINARY_SCENE_MAGIC));
+    header.version = BINARY_SCENE_VERSION;
+    header.sectionCount = BINARY_SCENE_SECTION_COUNT;
+    auto headerBytes = std::span<const char>(reinterpret_cast<const char *>(&header), sizeof(header));
+    uint64_t offset = sizeof(header);
+
+    bool ok = WriteAll(fd, headerBytes) &&
+        writeSection(fd, offset, header, BinarySceneSection::MATERIALS, data.materials.data(), data.materials.size()) &&
+        writeSection(fd, offset, header, BinarySceneSection::SPHERES,   data.spheres.data(),   data.spheres.size())   &&
+        writeSection(fd, offset, header, BinarySceneSection::PLANES,    data.planes.data(),    data.planes.size())    &&
+        writeSection(fd, offset, header, BinarySceneSection::CUBES,     data.cubes.data(),     data.cubes.size())     &&
+        writeSection(fd, offset, header, BinarySceneSection::POLYGONS,  data.polygons.data(),  data.polygons.size())  &&
+        writeSection(fd, offset, header, BinarySceneSection::VERTICES,  data.vertices.data(),  data.vertices.size())  &&
+        writeSection(fd, offset, header, BinarySceneSection::LIGHTS,    data.lights.data(),    data.lights.size())    &&
+        writeSection(fd, offset, header, BinarySceneSection::STRINGS,   data.strings.data(),   data.strings.size())   &&
+        writeSection(fd, offset, header, BinarySceneSection::ORDER,     data.order.data(),     data.order.size())     &&
+        writeSection(fd, offset, header, BinarySceneSection::MESHES,    data.meshes.data(),    data.meshes.size())    &&
+        writeSection(fd, offset, header, BinarySceneSection::GROUPS,    data.groups.data(),    data.groups.size());
+
+    // header goes last, once every section offset is known
+    ok = ok && ::pwrite(fd, headerBytes.data(), headerBytes.size(), 0) == static_cast<ssize_t>(headerBytes.size());
+    ok = ok && (::fsync(fd) == 0);
+    return (::close(fd) == 0) && ok;
+}
+
+bool IsBinaryScenePath(const std::string &path) {
+    return std::filesystem::path(path).extension() == BINARY_SCENE_EXTENSION;
+}
+
+bool ReadBinaryScene(const std::string &path, ParsedScene &scene) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+
+    struct stat st = {};
+    BinarySceneHeader header = {};
+    bool ok = ::fstat(fd, &st) == 0 && readAt(fd, 0, &header, sizeof(header)) &&
+              validHeader(header, static_cast<uint64_t>(st.st_size));
+
+    // the arrays the scene keeps are read in place, the typed ones are turned into records
+    std::vector<BinarySphere>  spheres;
+    std::vector<BinaryPlane>   planes;
+    std::vector<BinaryCube>    cubes;
+    std::vector<BinaryPolygon> polygons;
+    std::vector<BinaryLight>   lights;
+    std::vector<BinaryMesh>    meshes;
+    std::vector<uint8_t>       order;
+    std::vector<BinaryGroupMember> groups;
+    ok = ok &&
+        readSection(fd, header, BinarySceneSection::MATERIALS, scene.materials) &&
+        readSection(fd, header, BinarySceneSection::SPHERES,   spheres)         &&
+        readSection(fd, header, BinarySceneSection::PLANES,    planes)          &&
+        readSection(fd, header, BinarySceneSection::CUBES,     cubes)           &&
+        readSection(fd, header, BinarySceneSection::POLYGONS,  polygons)        &&
+        readSection(fd, header, BinarySceneSection::VERTICES,  scene.vertices)  &&
+        readSection(fd, header, BinarySceneSection::LIGHTS,    lights)          &&
+        readSection(fd, header, BinarySceneSection::STRINGS,   scene.text)      &&
+        readSection(fd, header, BinarySceneSection::ORDER,     order)           &&
+        readSection(fd, header, BinarySceneSection::MESHES,    meshes)          &&
+        readSection(fd, header, BinarySceneSection::GROUPS,    groups);
+    ::close(fd);
+
+    scene.records.clear();
+    scene.meshes.clear();
+    scene.skippedLines = 0;
+    if (!ok) {
+        std::cerr << "ReadBinaryScene : `" << path << "` is not a valid binary scene\n";
+        return false;
+    }
+
+    auto validString = [&scene](BinaryStringRef ref) { return static_cast<uint64_t>(ref.offset) + ref.length <= scene.text.size(); };
+    auto string = [&scene](BinaryStringRef ref) { return std::string_view(scene.text.data() + ref.offset, ref.length); };
+
+    // every record is checked against the arrays before it is added
+    size_t next[BINARY_SCENE_SECTION_COUNT] = {};
+    auto take = [&next](BinarySceneSection id, const auto &array) -> decltype(&array[0]) {
+        size_t &index = next[static_cast<size_t>(id)];
+        return (index < array.size() ? &array[index++] : nullptr);
+    };
+    auto add = [&scene](SceneRecordType type, const auto *stored) -> SceneRecord * {
+        if (stored->material >= scene.materials.size()) return nullptr;
+        SceneRecord &record = scene.records.emplace_back();
+        record.type = type;
+        if constexpr (requires { stored->position; }) {
+            std::copy(stored->position, stored->position + 3, record.position);
+        } else {
+            record.position[0] = stored->toWorld[3];
+            record.position[1] = stored->toWorld[7];
+            record.position[2] = stored->toWorld[11];
+        }
+        record.material = stored->material;
+        record.visibility = static_cast<uint8_t>(stored->visibility);
+        return &record;
+    };
+
+    scene.records.reserve(order.size());
+    size_t nextGroup = 0;
+    for (size_t i = 0; i < order.size(); i++) {
+        SceneRecord *record = nullptr;
+        switch (static_cast<BinarySceneSection>(order[i])) {
+        case BinarySceneSection::SPHERES:
+            if (auto s = take(BinarySceneSection::SPHERES, spheres); s && (record = add(SceneRecordType::SPHERE, s))) {
+                record->params[0] = s->radius;
+            }
+            break;
+        case BinarySceneSection::PLANES:
+            if (auto p = take(BinarySceneSection::PLANES, planes); p && (record = add(SceneRecordType::PLANE, p))) {
+                std::copy(p->normal, p->normal + 3, record->params);
+            }
+            break;
+        case BinarySceneSection::CUBES:
+            if (auto c = take(BinarySceneSection::CUBES, cubes); c && (record = add(SceneRecordType::CUBE, c))) {
+                std::copy(c->halfSize, c->halfSize + 3, record->params);
+            }
+            break;
+        case BinarySceneSection::POLYGONS:
+            if (auto p = take(BinarySceneSection::POLYGONS, polygons);
+                p && static_cast<uint64_t>(p->firstVertex) + p->vertexCount <= scene.vertices.size() &&
+                (record = add(SceneRecordType::POLYGON, p)))
+            {
+                record->firstVertex = p->firstVertex;
+                record->vertexCount = p->vertexCount;
+            }
+            break;
+        case BinarySceneSection::MESHES:
+            if (auto m = take(BinarySceneSection::MESHES, meshes);
+                m && m->path.length > 0 && validString(m->path) && (record = add(SceneRecordType::MESH, m)))
+            {
+                SceneMesh &mesh = scene.meshes.emplace_back();
+                std::copy(m->toWorld, m->toWorld + 12, mesh.toWorld);
+                mesh.path = string(m->path);
+                record->firstVertex = static_cast<uint32_t>(scene.meshes.size() - 1);
+            }
+            break;
+        case BinarySceneSection::LIGHTS:
+            if (auto l = take(BinarySceneSection::LIGHTS, lights); l && validString(l->record)) {
+                record = &scene.records.emplace_back();
+                record->type = SceneRecordType::LIGHT;
+                record->record = string(l->record);
+            }
+            break;
+        default:
+            break;
+        }
+        if (!record) scene.skippedLines++;
+
+        // members out of order are ignored, the record stays ungrouped
+        while (nextGroup < groups.size() && groups[nextGroup].record < i) nextGroup++;
+        if (nextGroup < groups.size() && groups[nextGroup].record == i) {
+            if (record && record->type != SceneRecordType::LIGHT) record->group = groups[nextGroup].group;
+            nextGroup++;
+        }
+    }
+
+    if (scene.skippedLines) {
+        std::cerr << "ReadBinaryScene : skipped " << scene.skippedLines << " malformed records\n";
+    }
+    return true;
+}
+
+bool BuildBinarySceneData(const ParsedScene &scene, BinarySceneData &data) {
+    // materials of binary loads are copied once each, text records are parsed once per spelling
+    std::vector<uint32_t> sceneMaterials(scene.materials.size(), NO_SCENE_MATERIAL);
+    std::unordered_map<std::string_view, uint32_t> textMaterials;
+    auto material = [&](const SceneRecord &record) {
+        if (record.material != NO_SCENE_MATERIAL) {
+            uint32_t &index = sceneMaterials[record.material];
+            if (index == NO_SCENE_MATERIAL) index = data.AddMaterial(scene.materials[record.material]);
+            return index;
+        }
+        auto [it, inserted] = textMaterials.try_emplace(record.record, NO_SCENE_MATERIAL);
+        BinaryMaterial parsed;
+        if (inserted && ParseBinaryMaterial(record.record, parsed)) it->second = data.AddMaterial(parsed);
+        return it->second;
+    };
+
+    data.order.reserve(scene.records.size());
+    for (const auto &record : scene.records) {
+        const float *pos = record.position;
+        const float *par = record.params;
+
+        if (record.type == SceneRecordType::LIGHT) {
+            data.AddLight(record.record);
+            data.order.push_back(static_cast<uint8_t>(BinarySceneSection::LIGHTS));
+            continue;
+        }
+
+        if (record.group != NO_SCENE_GROUP) {
+            data.groups.push_back({record.group, static_cast<uint32_t>(data.order.size()), 0});
+        }
+
+        uint32_t materialIndex = material(record);
+        if (materialIndex == NO_SCENE_MATERIAL) {
+            std::cerr << "BuildBinarySceneData : material `" << record.record << "` cannot be stored\n";
+            return false;
+        }
+
+        switch (record.type) {
+        case SceneRecordType::SPHERE:
+            data.spheres.push_back({{pos[0], pos[1], pos[2]}, par[0], materialIndex, record.visibility});
+            data.order.push_back(static_cast<uint8_t>(BinarySceneSection::SPHERES));
+            break;
+        case SceneRecordType::PLANE:
+            data.planes.push_back({{pos[0], pos[1], pos[2]}, {par[0], par[1], par[2]}, materialIndex, record.visibility});
+            data.order.push_back(static_cast<uint8_t>(BinarySceneSection::PLANES));
+            break;
+        case SceneRecordType::CUBE:
+            data.cubes.push_back({{pos[0], pos[1], pos[2]}, {par[0], par[1], par[2]}, materialIndex, record.visibility});
+            data.order.push_back(static_cast<uint8_t>(BinarySceneSection::CUBES));
+            break;
+        case SceneRecordType::POLYGON:
+            data.polygons.push_back({{pos[0], pos[1], pos[2]}, static_cast<uint32_t>(data.vertices.size()), record.vertexCount,
+                                     materialIndex, record.visibility, 0});
+            data.vertices.insert(data.vertices.end(), scene.vertices.begin() + record.firstVertex,
+                                 scene.vertices.begin() + record.firstVertex + record.vertexCount);
+            data.order.push_back(static_cast<uint8_t>(BinarySceneSection::POLYGONS));
+            break;
+        case SceneRecordType::MESH: {
+            BinaryMesh mesh = {{}, data.AddString(scene.meshes[record.firstVertex].path), materialIndex, record.visibility};
+            std::copy(scene.meshes[record.firstVertex].toWorld, scene.meshes[record.firstVertex].toWorld + 12, mesh.toWorld);
+            data.meshes.push_back(mesh);
+            data.order.push_back(static_cast<uint8_t>(BinarySceneSection::MESHES));
+            break;
+        }
+        case SceneRecordType::LIGHT:
+            break;
+        }
+    }
+    return true;
+}
+
+bool ConvertSceneFile(const std::string &srcPath, const std::string &dstPath) {
+    bool srcBinary = IsBinaryScenePath(srcPath);
+    if (srcBinary == IsBinaryScenePath(dstPath)) return false;
+
+    ParsedScene scene;
+    bool read = (srcBinary ? ReadBinaryScene(srcPath, scene) : ParseSceneFile(srcPath, scene));
+    return read && WriteSceneFile(dstPath, scene);
+}
+
+} // namespace roa
@@ -0,0 +1,284 @@
+#include <cassert>
+#include <charconv>
+#include <filesystem>
+#include <iostream>
+#include <span>
+
+#include <fcntl.h>
+#include <sys/file.h>
+#include <unistd.h>
+
+#include "Utilities/EditJournal.hpp"
+
+namespace roa
+{
+
+namespace
+{
+
+constexpr int MAX_CLAIMED_JOURNALS = 16;
+
+template <typename T>
+void appendNumber(std::vector<char> &out, T value) {
+    char buffer[32];
+    auto [ptr, ec] = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    out.insert(out.end(), buffer, ptr);
+}
+
+bool writeAll(int fd, std::span<const char> data) {
+    while (!data.empty()) {
+        ssize_t written = ::write(fd, data.data(), data.size());
+        if (written <= 0) return false;
+        data = data.subspan(static_cast<size_t>(written));
+    }
+    return true;
+}
+
+bool writeWhole(const std::string &path, std::span<const char> data) {
+    int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) return false;
+    bool ok = writeAll(fd, data) && ::fsync(fd) == 0;
+    return (::close(fd) == 0) && ok;
+}
+
+template <typename T>
+bool parseNumber(std::string_view &text, T &value) {
+    while (!text.empty() && text.front() == ' ') text.remove_prefix(1);
+    auto [ptr, ec] = std::from_chars(text.data(), text.data() + text.size(), value);
+    if (ec != std::errc()) return false;
+    text.remove_prefix(static_cast<size_t>(ptr - text.data()));
+    return true;
+}
+
+} // namespace
+
+// ---------------- EditJournal ----------------
+
+EditJournal::~EditJournal() {
+    Close();
+    if (lockFd >= 0) ::close(lockFd); // releases the flock
+}
+
+std::string EditJournal::Claim(const std::string &path_) {
+    if (lockFd >= 0) ::close(lockFd);
+    lockFd = -1;
+
+    std::filesystem::path base(path_);
+    for (int i = 1; i <= MAX_CLAIMED_JOURNALS; i++) {
+        std::filesystem::path candidate = base;
+        if (i > 1) candidate.replace_filename(base.stem().string() + "-" + std::to_string(i) + base.extension().string());
+
+        // the journal itself is replaced on compaction, so the lock lives in a file next to it
+        std::string lockPath = candidate.string() + ".lock";
+        int fd = ::open(lockPath.c_str(), O_RDWR | O_CREAT, 0644);
+        if (fd < 0) continue;
+        if (::flock(fd, LOCK_EX | LOCK_NB) == 0) {
+            lockFd = fd;
+            return candidate.string();
+        }
+        ::close(fd);
+    }
+
+    std::cerr << "EditJournal::Claim : every journal next to `" << path_ << "` is in use\n";
+    return {};
+}
+
+bool EditJournal::Open(const std::string &path_) {
+    Close();
+
+    path = path_;
+    fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+    if (fd < 0) return false;
+
+    {
+        std::lock_guard lock(mutex);
+        opened = true;
+        stopping = false;
+        pending.clear();
+        entriesSinceCompaction = 0;
+    }
+    writer = std::thread(&EditJournal::writerLoop, this);
+    return true;
+}
+
+void EditJournal::Close() {
+    {
+        std::lock_guard lock(mutex);
+        if (!opened) return;
+        opened = false;
+        stopping = true;
+    }
+    wakeUp.notify_one();
+    writer.join();
+
+    ::close(fd);
+    fd = -1;
+}
+
+void EditJournal::AppendAdd(uint64_t objectId, std::string_view sceneLine) {
+    std::vector<char> line;
+    FormatJournalAdd(objectId, sceneLine, line);
+    append({line.data(), line.size()});
+}
+
+void EditJournal::AppendErase(uint64_t objectId) {
+    appendIdLine('D', objectId);
+}
+
+void EditJournal::AppendGroup(uint64_t objectId) {
+    appendIdLine('G', objectId);
+}
+
+void EditJournal::AppendSet(uint64_t objectId, SceneField field, float value) {
+    char line[96] = {'S', ' '};
+    char *end = line + sizeof(line);
+    char *ptr = line + 2;
+
+    // each number is followed by its separator, so it has to leave room for one
+    auto put = [&ptr, end](auto number, char separator) {
+        auto result = std::to_chars(ptr, end, number);
+        if (result.ec != std::errc() || result.ptr == end) return false;
+        ptr = result.ptr;
+        *ptr++ = separator;
+        return true;
+    };
+    if (!put(objectId, ' ') || !put(static_cast<int>(field), ' ') || !put(value, '\n')) {
+        std::cerr << "EditJournal::AppendSet : failed to format the entry\n";
+        return;
+    }
+    append({line, static_cast<size_t>(ptr - line)});
+}
+
+void EditJournal::Compact(std::function<void(std::vector<char> &lines)> formatSnapshot) {
+    assert(formatSnapshot);
+    {
+        std::lock_guard lock(mutex);
+        if (!opened) return;
+        pending.clear();
+        compaction = std::move(formatSnapshot);
+        entriesSinceCompaction = 0;
+    }
+    wakeUp.notify_one();
+}
+
+size_t EditJournal::GetEntriesSinceCompaction() {
+    std::lock_guard lock(mutex);
+    return entriesSinceCompaction;
+}
+
+void EditJournal::appendIdLine(char kind, uint64_t objectId) {
+    char line[32] = {kind, ' '};
+    char *end = line + sizeof(line) - 1; // room for the newline
+    auto [ptr, ec] = std::to_chars(line + 2, end, objectId);
+    if (ec != std::errc()) {
+        std::cerr << "EditJournal : failed to format a `" << kind << "` entry\n";
+        return;
+    }
+    *ptr++ = '\n';
+    append({line, static_cast<size_t>(ptr - line)});
+}
+
+void EditJournal::append(std::string_view line) {
+    std::lock_guard lock(mutex);
+    if (!opened) return;
+    pending.insert(pending.end(), line.begin(), line.end());
+    entriesSinceCompaction++;
+}
+
+void EditJournal::writerLoop() {
+    std::vector<char> toWrite;
+    std::vector<char> toCompact;
+
+    while (true) {
+        std::function<void(std::vector<char> &)> formatSnapshot;
+        bool stop = false;
+        {
+            std::unique_lock lock(mutex);
+            wakeUp.wait_for(lock, FLUSH_INTERVAL, [this]{ return stopping || compaction; });
+
+            formatSnapshot.swap(compaction);
+            toWrite.swap(pending);
+            stop = stopping;
+        }
+
+        if (formatSnapshot) {
+            formatSnapshot(toCompact);
+            // the new file is complete before it replaces the old one
+            std::string tmpPath = path + ".tmp";
+            std::error_code ec;
+            bool replaced = writeWhole(tmpPath, toCompact);
+            if (replaced) std::filesystem::rename(tmpPath, path, ec);
+            replaced = replaced && !ec;
+            if (replaced) {
+                ::close(fd);
+                fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+            }
+            if (!replaced) std::cerr << "EditJournal : compaction of `" << path << "` failed\n";
+            toCompact.clear();
+        }
+
+        if (!toWrite.empty()) {
+            if (fd < 0 || !writeAll(fd, toWrite) || ::fdatasync(fd) != 0) {
+                std::cerr << "EditJournal : failed to write `" << path << "`\n";
+            }
+            toWrite.clear();
+        }
+
+        if (stop) return;
+    }
+}
+
+// ---------------- format ----------------
+
+void FormatJournalAdd(uint64_t objectId, std::string_view sceneLine, std::vector<char> &out) {
+    out.push_back('A');
+    out.push_back(' ');
+    appendNumber(out, objectId);
+    out.push_back(' ');
+    out.insert(out.end(), sceneLine.begin(), sceneLine.end());
+    out.push_back('\n');
+}
+
+std::vector<JournalEntry> ParseJournal(std::string_view text) {
+    std::vector<JournalEntry> entries;
+    size_t skipped = 0;
+
+    while (!text.empty()) {
+        size_t lineEnd = text.find('\n');
+        if (lineEnd == std::string_view::npos) break; // torn write
+        std::string_view line = text.substr(0, lineEnd);
+        text.remove_prefix(lineEnd + 1);
+        if (line.size() < 2) continue;
+
+        JournalEntry entry;
+        char kind = line.front();
+        line.remove_prefix(1);
+        bool ok = parseNumber(line, entry.objectId);
+
+        if (kind == 'A') {
+            entry.kind = JournalEntry::Kind::ADD;
+            if (!line.empty() && line.front() == ' ') line.remove_prefix(1);
+            entry.record = line;
+        } else if (kind == 'D') {
+            entry.kind = JournalEntry::Kind::ERASE;
+        } else if (kind == 'G') {
+            entry.kind = JournalEntry::Kind::GROUP;
+        } else if (kind == 'S') {
+            int field = 0;
+            entry.kind = JournalEntry::Kind::SET;
+            ok = ok && parseNumber(line, field) && parseNumber(line, entry.value) &&
+                 field >= 0 && field < static_cast<int>(SceneField::COUNT);
+            entry.field = static_cast<SceneField>(field);
+        } else {
+            ok = false;
+        }
+
+        if (ok) entries.push_back(entry);
+        else skipped++;
+    }
+
+    if (skipped) std::cerr << "ParseJournal : skipped " << skipped << " malformed lines\n";
+    return entries;
+}
+
+} // namespace roa
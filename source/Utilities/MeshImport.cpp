@@ -0,0 +1,421 @@
+#include <algorithm>
+#include <bit>
+#include <charconv>
+#include <cstring>
+#include <exception>
+#include <filesystem>
+#include <iostream>
+#include <string_view>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "Utilities/MeshImport.hpp"
+
+namespace roa
+{
+
+namespace
+{
+
+// Read-only mapping of a whole file, read sequentially.
+class MappedFile {
+    void  *mapping = nullptr;
+    size_t size = 0;
+
+public:
+    MappedFile() = default;
+    ~MappedFile() { if (mapping) ::munmap(mapping, size); }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool Open(const std::string &path) {
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) return false;
+
+        struct stat st = {};
+        if (::fstat(fd, &st) != 0 || st.st_size <= 0) {
+            ::close(fd);
+            return false;
+        }
+
+        size = static_cast<size_t>(st.st_size);
+        mapping = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (mapping == MAP_FAILED) {
+            mapping = nullptr;
+            return false;
+        }
+        // pages are read ahead and dropped behind the parser
+        ::madvise(mapping, size, MADV_SEQUENTIAL);
+        return true;
+    }
+
+    std::string_view GetText() const { return {static_cast<const char *>(mapping), size}; }
+};
+
+bool isBlank(char c) { return c == ' ' || c == '\t' || c == '\r'; }
+
+void skipBlanks(const char *&pos, const char *end) {
+    while (pos < end && isBlank(*pos)) pos++;
+}
+
+template <typename T>
+bool readNumber(const char *&pos, const char *end, T &value) {
+    skipBlanks(pos, end);
+    if (pos < end && *pos == '+') pos++;
+    auto [ptr, ec] = std::from_chars(pos, end, value);
+    if (ec != std::errc()) return false;
+    pos = ptr;
+    return true;
+}
+
+// Appends polygon `corners` as a triangle fan.
+void addFan(std::vector<uint32_t> &indices, const std::vector<uint32_t> &corners) {
+    for (size_t i = 1; i + 1 < corners.size(); i++) {
+        indices.push_back(corners[0]);
+        indices.push_back(corners[i]);
+        indices.push_back(corners[i + 1]);
+    }
+}
+
+// ---------------- PLY ----------------
+
+enum class PlyType : uint8_t { INT8, UINT8, INT16, UINT16, INT32, UINT32, FLOAT32, FLOAT64, INVALID };
+
+PlyType parsePlyType(std::string_view name) {
+    if (name == "char"   || name == "int8")    return PlyType::INT8;
+    if (name == "uchar"  || name == "uint8")   return PlyType::UINT8;
+    if (name == "short"  || name == "int16")   return PlyType::INT16;
+    if (name == "ushort" || name == "uint16")  return PlyType::UINT16;
+    if (name == "int"    || name == "int32")   return PlyType::INT32;
+    if (name == "uint"   || name == "uint32")  return PlyType::UINT32;
+    if (name == "float"  || name == "float32") return PlyType::FLOAT32;
+    if (name == "double" || name == "float64") return PlyType::FLOAT64;
+    return PlyType::INVALID;
+}
+
+size_t plyTypeSize(PlyType type) {
+    switch (type) {
+        case PlyType::INT8:    case PlyType::UINT8:   return 1;
+        case PlyType::INT16:   case PlyType::UINT16:  return 2;
+        case PlyType::INT32:   case PlyType::UINT32:
+        case PlyType::FLOAT32:                        return 4;
+        case PlyType::FLOAT64:                        return 8;
+        case PlyType::INVALID:                        return 0;
+    }
+    return 0;
+}
+
+struct PlyProperty {
+    std::string name;
+    PlyType     type = PlyType::INVALID;
+    PlyType     countType = PlyType::INVALID; // != INVALID for lists
+};
+
+struct PlyElement {
+    std::string              name;
+    uint64_t                 count = 0;
+    std::vector<PlyProperty> properties;
+
+    // bytes one element takes at least, lists counted as empty
+    size_t GetMinSize() const {
+        size_t size = 0;
+        for (const auto &property : properties) {
+            size += plyTypeSize(property.countType != PlyType::INVALID ? property.countType : property.type);
+        }
+        return std::max<size_t>(size, 1);
+    }
+};
+
+// Binary body reader, swaps bytes when the file endianness differs from ours.
+class PlyReader {
+    const char *pos;
+    const char *end;
+    bool        swap;
+
+public:
+    PlyReader(const char *pos_, const char *end_, bool swap_): pos(pos_), end(end_), swap(swap_) {}
+
+    size_t GetRemaining() const { return static_cast<size_t>(end - pos); }
+
+    // How many of `element` the rest of the body can hold, so a corrupt header
+    // count is never trusted for an allocation.
+    size_t CapCount(const PlyElement &element) const {
+        return static_cast<size_t>(std::min<uint64_t>(element.count, GetRemaining() / element.GetMinSize()));
+    }
+
+    bool Read(PlyType type, double &value) {
+        size_t size = plyTypeSize(type);
+        if (static_cast<size_t>(end - pos) < size) return false;
+
+        unsigned char bytes[8];
+        std::memcpy(bytes, pos, size);
+        if (swap) std::reverse(bytes, bytes + size);
+        pos += size;
+
+        switch (type) {
+            case PlyType::INT8:    value = load<int8_t>(bytes);   break;
+            case PlyType::UINT8:   value = load<uint8_t>(bytes);  break;
+            case PlyType::INT16:   value = load<int16_t>(bytes);  break;
+            case PlyType::UINT16:  value = load<uint16_t>(bytes); break;
+            case PlyType::INT32:   value = load<int32_t>(bytes);  break;
+            case PlyType::UINT32:  value = load<uint32_t>(bytes); break;
+            case PlyType::FLOAT32: value = load<float>(bytes);    break;
+            case PlyType::FLOAT64: value = load<double>(bytes);   break;
+            case PlyType::INVALID: return false;
+        }
+        return true;
+    }
+
+    bool Skip(const PlyProperty &property) {
+        double value = 0;
+        if (property.countType == PlyType::INVALID) return Read(property.type, value);
+
+        if (!Read(property.countType, value) || value < 0) return false;
+        size_t bytes = static_cast<size_t>(value) * plyTypeSize(property.type);
+        if (static_cast<size_t>(end - pos) < bytes) return false;
+        pos += bytes;
+        return true;
+    }
+
+private:
+    template <typename T>
+    static T load(const unsigned char *bytes) {
+        T value;
+        std::memcpy(&value, bytes, sizeof(T));
+        return value;
+    }
+};
+
+bool parsePlyHeader(std::string_view &text, std::vector<PlyElement> &elements, bool &bigEndian) {
+    if (!text.starts_with("ply")) return false;
+
+    bool formatKnown = false;
+    while (!text.empty()) {
+        size_t lineEnd = text.find('\n');
+        if (lineEnd == std::string_view::npos) return false;
+        std::string_view line = text.substr(0, lineEnd);
+        text.remove_prefix(lineEnd + 1);
+        if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+
+        auto word = [&line]() {
+            while (!line.empty() && isBlank(line.front())) line.remove_prefix(1);
+            size_t wordEnd = std::min(line.size(), line.find_first_of(" \t"));
+            std::string_view result = line.substr(0, wordEnd);
+            line.remove_prefix(wordEnd);
+            return result;
+        };
+
+        std::string_view keyword = word();
+        if (keyword == "end_header") return formatKnown && !elements.empty();
+
+        if (keyword == "format") {
+            std::string_view format = word();
+            if (format == "binary_little_endian") bigEndian = false;
+            else if (format == "binary_big_endian") bigEndian = true;
+            else {
+                std::cerr << "ImportPLY : unsupported format `" << format << "`\n";
+                return false;
+            }
+            formatKnown = true;
+        } else if (keyword == "element") {
+            PlyElement &element = elements.emplace_back();
+            element.name = word();
+            std::string_view count = word();
+            if (std::from_chars(count.data(), count.data() + count.size(), element.count).ec != std::errc()) return false;
+        } else if (keyword == "property") {
+            if (elements.empty()) return false;
+            PlyProperty property;
+            std::string_view type = word();
+            if (type == "list") {
+                property.countType = parsePlyType(word());
+                if (property.countType == PlyType::INVALID) return false;
+                type = word();
+            }
+            property.type = parsePlyType(type);
+            property.name = word();
+            if (property.type == PlyType::INVALID) return false;
+            elements.back().properties.push_back(property);
+        }
+        // comment, obj_info and unknown lines are skipped
+    }
+    return false;
+}
+
+bool readPlyVertices(PlyReader &reader, const PlyElement &element, ImportedMesh &mesh) {
+    int axisOf[3] = {-1, -1, -1};
+    std::vector<int> propertyAxis(element.properties.size(), -1);
+    for (size_t i = 0; i < element.properties.size(); i++) {
+        const PlyProperty &property = element.properties[i];
+        if (property.countType != PlyType::INVALID) continue;
+        if (property.name == "x") propertyAxis[i] = 0;
+        if (property.name == "y") propertyAxis[i] = 1;
+        if (property.name == "z") propertyAxis[i] = 2;
+        if (propertyAxis[i] >= 0) axisOf[propertyAxis[i]] = static_cast<int>(i);
+    }
+    if (axisOf[0] < 0 || axisOf[1] < 0 || axisOf[2] < 0) return false;
+
+    mesh.vertices.reserve(mesh.vertices.size() + reader.CapCount(element));
+    for (uint64_t v = 0; v < element.count; v++) {
+        MeshVertex vertex = {};
+        for (size_t i = 0; i < element.properties.size(); i++) {
+            if (propertyAxis[i] < 0) {
+                if (!reader.Skip(element.properties[i])) return false;
+                continue;
+            }
+            double value = 0;
+            if (!reader.Read(element.properties[i].type, value)) return false;
+            vertex.position[propertyAxis[i]] = static_cast<float>(value);
+        }
+        mesh.vertices.push_back(vertex);
+    }
+    return true;
+}
+
+bool readPlyFaces(PlyReader &reader, const PlyElement &element, ImportedMesh &mesh) {
+    auto isIndexList = [](const PlyProperty &property) {
+        return property.countType != PlyType::INVALID &&
+               (property.name == "vertex_indices" || property.name == "vertex_index");
+    };
+    auto listIt = std::find_if(element.properties.begin(), element.properties.end(), isIndexList);
+    if (listIt == element.properties.end()) return false;
+
+    // most files are all triangles
+    mesh.indices.reserve(mesh.indices.size() + reader.CapCount(element) * 3);
+    std::vector<uint32_t> corners;
+    for (uint64_t f = 0; f < element.count; f++) {
+        for (const auto &property : element.properties) {
+            if (&property != &*listIt) {
+                if (!reader.Skip(property)) return false;
+                continue;
+            }
+
+            double count = 0;
+            if (!reader.Read(property.countType, count) || count < 0) return false;
+            if (count * plyTypeSize(property.type) > static_cast<double>(reader.GetRemaining())) return false;
+            corners.clear();
+            for (size_t i = 0; i < static_cast<size_t>(count); i++) {
+                double index = 0;
+                if (!reader.Read(property.type, index)) return false;
+                corners.push_back(static_cast<uint32_t>(index));
+            }
+            addFan(mesh.indices, corners);
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+bool ImportOBJ(const std::string &path, ImportedMesh &mesh) {
+    MappedFile file;
+    if (!file.Open(path)) return false;
+
+    std::string_view text = file.GetText();
+    const char *pos = text.data();
+    const char *end = pos + text.size();
+
+    std::vector<uint32_t> corners;
+    size_t skipped = 0;
+
+    while (pos < end) {
+        const char *lineEnd = static_cast<const char *>(std::memchr(pos, '\n', static_cast<size_t>(end - pos)));
+        if (!lineEnd) lineEnd = end;
+
+        skipBlanks(pos, lineEnd);
+        if (lineEnd - pos >= 2 && pos[0] == 'v' && isBlank(pos[1])) {
+            pos++;
+            MeshVertex vertex = {};
+            bool ok = readNumber(pos, lineEnd, vertex.position[0]) &&
+                      readNumber(pos, lineEnd, vertex.position[1]) &&
+                      readNumber(pos, lineEnd, vertex.position[2]);
+            if (ok) mesh.vertices.push_back(vertex);
+            else skipped++;
+        } else if (lineEnd - pos >= 2 && pos[0] == 'f' && isBlank(pos[1])) {
+            pos++;
+            corners.clear();
+            int64_t index = 0;
+            while (readNumber(pos, lineEnd, index)) {
+                // 1-based, negative ones count back from the last vertex
+                int64_t resolved = (index < 0 ? static_cast<int64_t>(mesh.vertices.size()) + index : index - 1);
+                corners.push_back(resolved < 0 ? UINT32_MAX : static_cast<uint32_t>(resolved));
+                while (pos < lineEnd && !isBlank(*pos)) pos++; // texture and normal indices
+            }
+            if (corners.size() >= 3) addFan(mesh.indices, corners);
+            else skipped++;
+        }
+
+        pos = (lineEnd < end ? lineEnd + 1 : end);
+    }
+
+    if (skipped) std::cerr << "ImportOBJ : skipped " << skipped << " malformed lines\n";
+    return !mesh.indices.empty();
+}
+
+bool ImportPLY(const std::string &path, ImportedMesh &mesh) {
+    MappedFile file;
+    if (!file.Open(path)) return false;
+
+    std::string_view text = file.GetText();
+    std::vector<PlyElement> elements;
+    bool bigEndian = false;
+    if (!parsePlyHeader(text, elements, bigEndian)) {
+        std::cerr << "ImportPLY : `" << path << "` has no valid binary ply header\n";
+        return false;
+    }
+
+    bool swap = (bigEndian != (std::endian::native == std::endian::big));
+    PlyReader reader(text.data(), text.data() + text.size(), swap);
+
+    for (const auto &element : elements) {
+        bool ok = true;
+        if (element.name == "vertex") {
+            ok = readPlyVertices(reader, element, mesh);
+        } else if (element.name == "face") {
+            ok = readPlyFaces(reader, element, mesh);
+        } else {
+            for (uint64_t i = 0; ok && i < element.count; i++) {
+                for (const auto &property : element.properties) ok = ok && reader.Skip(property);
+            }
+        }
+
+        if (!ok) {
+            std::cerr << "ImportPLY : `" << path << "` is truncated in element `" << element.name << "`\n";
+            return false;
+        }
+    }
+    return !mesh.indices.empty();
+}
+
+bool IsMeshPath(const std::string &path) {
+    std::filesystem::path extension = std::filesystem::path(path).extension();
+    return extension == ".obj" || extension == ".ply";
+}
+
+bool ImportMesh(const std::string &path, ImportedMesh &mesh) {
+    std::filesystem::path extension = std::filesystem::path(path).extension();
+    if (extension == ".obj") return ImportOBJ(path, mesh);
+    if (extension == ".ply") return ImportPLY(path, mesh);
+    return false;
+}
+
+std::shared_ptr<const TriangleMesh> LoadTriangleMesh(const std::string &path) {
+    std::shared_ptr<const TriangleMesh> mesh;
+    // callers run on worker threads, an escaping exception would terminate the application
+    try {
+        ImportedMesh imported;
+        if (ImportMesh(path, imported)) {
+            mesh = std::make_shared<const TriangleMesh>(std::move(imported.vertices), std::move(imported.indices));
+        }
+    } catch (const std::exception &e) {
+        std::cerr << "LoadTriangleMesh : failed to import `" << path << "` : " << e.what() << "\n";
+        return nullptr;
+    }
+    return (mesh && !mesh->Empty() ? mesh : nullptr);
+}
+
+} // namespace roa
@@ -1,3 +1,5 @@
+#include <cmath>
+
 #include "Utilities/ROACommon.hpp"
 
 namespace roa
@@ -10,6 +12,20 @@ dr4::Vec2f getClampedDotInRect(const dr4::Vec2f dot, const dr4::Rect2f rect) {
     return result;
 }
 
+dr4::Rect2f uniteRects(const dr4::Rect2f a, const dr4::Rect2f b) {
+    dr4::Vec2f min = {std::fmin(a.pos.x, b.pos.x), std::fmin(a.pos.y, b.pos.y)};
+    dr4::Vec2f max = {std::fmax(a.pos.x + a.size.x, b.pos.x + b.size.x), std::fmax(a.pos.y + a.size.y, b.pos.y + b.size.y)};
+    dr4::Rect2f result;
+    result.pos = min;
+    result.size = max - min;
+    return result;
+}
+
+bool rectsIntersect(const dr4::Rect2f a, const dr4::Rect2f b) {
+    return a.pos.x < b.pos.x + b.size.x && b.pos.x < a.pos.x + a.size.x &&
+           a.pos.y < b.pos.y + b.size.y && b.pos.y < a.pos.y + a.size.y;
+}
+
 std::ostream &operator<< (std::ostream &stream, const dr4::Vec2f vec) {
     stream << "dr4::Vec2f{" << vec.x << ", " << vec.y << "}";
     return stream;
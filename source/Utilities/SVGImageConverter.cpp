@@ -1,8 +1,13 @@
 #include <vector>
 #include <iostream>
 #include <cassert>
+#include <cstring>
+#include <mutex>
 #include <stdexcept>
+#include <tuple>
+#include <unordered_map>
 
+#include "Utilities/IconAtlas.hpp"
 #include "Utilities/SVGImageConverter.hpp"
 
 #define NANOSVG_IMPLEMENTATION
@@ -11,22 +16,37 @@
 #define NANOSVGRAST_IMPLEMENTATION
 #include "Utilities/nanosvgrast.h"
 
-void ExtractSVG(const std::string &path, dr4::Vec2f pixelSize, std::function<void(int,int,dr4::Color)> putPixel) {
-    assert(putPixel);
+namespace
+{
+
+struct SVGRasterKey {
+    std::string path;
+    int         width;
+    int         height;
 
+    bool operator==(const SVGRasterKey &other) const = default;
+};
+
+struct SVGRasterKeyHash {
+    size_t operator()(const SVGRasterKey &key) const {
+        size_t hash = std::hash<std::string>{}(key.path);
+        hash ^= std::hash<int>{}(key.width)  + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+        hash ^= std::hash<int>{}(key.height) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+        return hash;
+    }
+};
+
+// Icons are few and small, entries are never evicted.
+std::unordered_map<SVGRasterKey, SVGRaster, SVGRasterKeyHash> rasterCache;
+std::mutex rasterCacheMutex;
+
+SVGRaster rasterize(const std::string &path, int w, int h) {
     NSVGimage* img = nsvgParseFromFile(path.c_str(), "px", 96);
     if (img == nullptr) {
         throw std::invalid_argument("nsvgParseFromFile `" + path + "` failed");
     }
 
-    if (pixelSize.x < 0 || pixelSize.y < 0) {
-        throw std::invalid_argument("PixelSize " + std::to_string(pixelSize.x) + " " + std::to_string(pixelSize.y) + " is incorrect");
-    }
-
-    int w = static_cast<int>(pixelSize.x);
-    int h = static_cast<int>(pixelSize.y);
-
-    std::vector<unsigned char> pixels(w * h * 4);
+    SVGRaster raster = {w, h, std::vector<unsigned char>(w * h * 4)};
 
     NSVGrasterizer* rast = nsvgCreateRasterizer();
     if (rast == nullptr) {
@@ -42,11 +62,64 @@ void ExtractSVG(const std::string &path, dr4::Vec2f pixelSize, std::function<voi
         img,          
         0, 0,         
         scale,        
-        pixels.data(),
+        raster.rgba.data(),
         w, h,        
         w * 4
     );
 
+    nsvgDeleteRasterizer(rast);
+    nsvgDelete(img);
+    return raster;
+}
+
+// "./assets/x.svg" and "assets/x.svg" are the same icon
+std::string_view normalizedIconPath(std::string_view path) {
+    while (path.starts_with("./")) path.remove_prefix(2);
+    return path;
+}
+
+} // namespace
+
+const unsigned char *FindBakedIcon(std::string_view path, int width, int height) {
+    path = normalizedIconPath(path);
+    for (size_t i = 0; i < BAKED_ICON_COUNT; i++) {
+        const BakedIcon &icon = BAKED_ICONS[i];
+        if (icon.width == width && icon.height == height && normalizedIconPath(icon.path) == path)
+            return BAKED_ICON_PIXELS + icon.offset;
+    }
+    return nullptr;
+}
+
+const SVGRaster &RasterizeSVG(const std::string &path, dr4::Vec2f pixelSize) {
+    if (pixelSize.x < 0 || pixelSize.y < 0) {
+        throw std::invalid_argument("PixelSize " + std::to_string(pixelSize.x) + " " + std::to_string(pixelSize.y) + " is incorrect");
+    }
+
+    SVGRasterKey key = {path, static_cast<int>(pixelSize.x), static_cast<int>(pixelSize.y)};
+
+    std::lock_guard lock(rasterCacheMutex);
+    auto it = rasterCache.find(key);
+    if (it != rasterCache.end()) return it->second;
+
+    SVGRaster raster;
+    if (const unsigned char *baked = FindBakedIcon(path, key.width, key.height)) {
+        raster = {key.width, key.height, std::vector<unsigned char>(key.width * key.height * 4)};
+        std::memcpy(raster.rgba.data(), baked, raster.rgba.size());
+    } else {
+        // a failed parse throws and is not cached
+        raster = rasterize(path, key.width, key.height);
+    }
+    return rasterCache.emplace(std::move(key), std::move(raster)).first->second;
+}
+
+void ExtractSVG(const std::string &path, dr4::Vec2f pixelSize, std::function<void(int,int,dr4::Color)> putPixel) {
+    assert(putPixel);
+
+    const SVGRaster &raster = RasterizeSVG(path, pixelSize);
+    const std::vector<unsigned char> &pixels = raster.rgba;
+    int w = raster.width;
+    int h = raster.height;
+
     for (int y = 0; y < h; y++) {
         for (int x = 0; x < w; x++) {
         int i = (y * w + x) * 4;
@@ -60,7 +133,4 @@ void ExtractSVG(const std::string &path, dr4::Vec2f pixelSize, std::function<voi
         putPixel(x, y, color);
         }
     }
-
-    nsvgDeleteRasterizer(rast);
-    nsvgDelete(img);
-};
\ No newline at end of file
+};
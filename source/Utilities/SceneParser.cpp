@@ -0,0 +1,279 @@
+#include <algorithm>
+#include <charconv>
+#include <fstream>
+#include <iostream>
+#include <thread>
+
+#include "Utilities/SceneParser.hpp"
+
+namespace roa
+{
+
+namespace
+{
+
+constexpr size_t MIN_CHUNK_SIZE = 256 * 1024;
+
+bool isSpace(char c) {
+    return c == ' ' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+}
+
+// Cursor over one line. Never allocates.
+class LineParser {
+    const char *cur;
+    const char *end;
+
+public:
+    LineParser(const char *begin, const char *end_): cur(begin), end(end_) {}
+
+    std::string_view Word() {
+        skipSpaces();
+        const char *start = cur;
+        while (cur < end && !isSpace(*cur)) cur++;
+        return {start, static_cast<size_t>(cur - start)};
+    }
+
+    template <typename T>
+    bool Number(T &value) {
+        skipSpaces();
+        if (cur < end && *cur == '+') cur++;
+        auto [ptr, ec] = std::from_chars(cur, end, value);
+        if (ec != std::errc()) return false;
+        cur = ptr;
+        return true;
+    }
+
+    bool Numbers(float *values, size_t count) {
+        for (size_t i = 0; i < count; i++) {
+            if (!Number(values[i])) return false;
+        }
+        return true;
+    }
+
+    // `count` bytes after a single space, e.g. a length-prefixed path that may hold spaces
+    bool Bytes(size_t count, std::string_view &bytes) {
+        if (cur >= end || *cur != ' ' || static_cast<size_t>(end - cur - 1) < count) return false;
+        bytes = {cur + 1, count};
+        cur += count + 1;
+        return true;
+    }
+
+    std::string_view Rest() {
+        skipSpaces();
+        const char *last = end;
+        while (last > cur && isSpace(*(last - 1))) last--;
+        return {cur, static_cast<size_t>(last - cur)};
+    }
+
+private:
+    void skipSpaces() {
+        while (cur < end && isSpace(*cur)) cur++;
+    }
+};
+
+// Strips an optional trailing `<field> <number>` off a material record.
+template <typename T>
+bool splitTrailingField(std::string_view &record, std::string_view field, T &value) {
+    size_t pos = record.rfind(field);
+    if (pos == std::string_view::npos) return false;
+    if (pos != 0 && !isSpace(record[pos - 1])) return false;
+
+    LineParser tail(record.data() + pos + field.size(), record.data() + record.size());
+    T parsed = {};
+    if (!tail.Number(parsed) || !tail.Rest().empty()) return false;
+
+    value = parsed;
+    record = record.substr(0, pos);
+    while (!record.empty() && isSpace(record.back())) record.remove_suffix(1);
+    return true;
+}
+
+struct ChunkResult {
+    std::vector<SceneRecord>  records;
+    std::vector<BinaryVertex> vertices;
+    std::vector<SceneMesh>    meshes;
+    size_t                    skippedLines = 0;
+};
+
+// position is written as x y z followed by a homogeneous 0
+bool parsePosition(LineParser &line, SceneRecord &record) {
+    float w = 0;
+    return line.Numbers(record.position, 3) && line.Number(w);
+}
+
+bool parseLine(const char *begin, const char *end, ChunkResult &result) {
+    LineParser line(begin, end);
+    std::string_view objectName = line.Word();
+    if (objectName.empty()) return true;
+
+    SceneRecord record;
+    bool ok = false;
+
+    if (objectName == "Light") {
+        record.type = SceneRecordType::LIGHT;
+        record.record = line.Rest();
+        result.records.push_back(record);
+        return true;
+    }
+
+    if (objectName == "Sphere") {
+        record.type = SceneRecordType::SPHERE;
+        ok = parsePosition(line, record) && line.Number(record.params[0]);
+    } else if (objectName == "Plane") {
+        record.type = SceneRecordType::PLANE;
+        ok = parsePosition(line, record) && line.Numbers(record.params, 3);
+    } else if (objectName == "Cube") {
+        record.type = SceneRecordType::CUBE;
+        ok = parsePosition(line, record) && line.Numbers(record.params, 3);
+    } else if (objectName == "Polygon") {
+        record.type = SceneRecordType::POLYGON;
+        ok = parsePosition(line, record) && line.Number(record.vertexCount);
+        record.firstVertex = static_cast<uint32_t>(result.vertices.size());
+        for (uint32_t i = 0; ok && i < record.vertexCount; i++) {
+            BinaryVertex vertex = {};
+            ok = line.Numbers(vertex.position, 3);
+            result.vertices.push_back(vertex);
+        }
+        if (!ok) result.vertices.resize(record.firstVertex);
+    } else if (objectName == "Mesh") {
+        record.type = SceneRecordType::MESH;
+        SceneMesh mesh;
+        size_t pathSize = 0;
+        ok = line.Numbers(mesh.toWorld, 12) && line.Number(pathSize) && pathSize > 0 && line.Bytes(pathSize, mesh.path);
+        record.position[0] = mesh.toWorld[3];
+        record.position[1] = mesh.toWorld[7];
+        record.position[2] = mesh.toWorld[11];
+        record.firstVertex = static_cast<uint32_t>(result.meshes.size());
+        if (ok) result.meshes.push_back(mesh);
+    }
+
+    if (!ok) return false;
+
+    record.record = line.Rest();
+    splitTrailingField(record.record, "Group", record.group);
+    int visibility = RAY_VISIBILITY_ALL;
+    if (splitTrailingField(record.record, "Visibility", visibility)) record.visibility = static_cast<uint8_t>(visibility);
+    result.records.push_back(record);
+    return true;
+}
+
+void parseChunk(const char *begin, const char *end, ChunkResult &result, std::stop_token stop) {
+    // rough guess of ~64 bytes per line keeps reallocations rare
+    result.records.reserve(static_cast<size_t>(end - begin) / 64);
+
+    while (begin < end && !stop.stop_requested()) {
+        const char *lineEnd = std::find(begin, end, '\n');
+        if (!parseLine(begin, lineEnd, result)) result.skippedLines++;
+        begin = (lineEnd < end ? lineEnd + 1 : end);
+    }
+}
+
+} // namespace
+
+void ParseSceneText(std::vector<char> text, ParsedScene &scene, size_t threadCount, std::stop_token stop) {
+    scene.text = std::move(text);
+    scene.records.clear();
+    scene.vertices.clear();
+    scene.materials.clear();
+    scene.meshes.clear();
+    scene.skippedLines = 0;
+
+    const char *begin = scene.text.data();
+    const char *end   = begin + scene.text.size();
+
+    if (threadCount == 0) {
+        size_t hardwareThreads = std::max(1u, std::thread::hardware_concurrency());
+        threadCount = std::min(hardwareThreads, scene.text.size() / MIN_CHUNK_SIZE + 1);
+    }
+
+    // chunk boundaries are moved forward to the next line start
+    std::vector<const char *> bounds = {begin};
+    for (size_t i = 1; i < threadCount; i++) {
+        const char *bound = std::max(bounds.back(), begin + scene.text.size() * i / threadCount);
+        bound = std::find(bound, end, '\n');
+        bounds.push_back(bound < end ? bound + 1 : end);
+    }
+    bounds.push_back(end);
+
+    std::vector<ChunkResult> results(threadCount);
+    {
+        std::vector<std::jthread> workers;
+        for (size_t i = 1; i < threadCount; i++) {
+            workers.emplace_back(parseChunk, bounds[i], bounds[i + 1], std::ref(results[i]), stop);
+        }
+        parseChunk(bounds[0], bounds[1], results[0], stop);
+    }
+
+    size_t recordCount = 0, vertexCount = 0;
+    for (const auto &result : results) {
+        recordCount += result.records.size();
+        vertexCount += result.vertices.size();
+    }
+    scene.records.reserve(recordCount);
+    scene.vertices.reserve(vertexCount);
+
+    for (auto &result : results) {
+        uint32_t vertexOffset = static_cast<uint32_t>(scene.vertices.size());
+        uint32_t meshOffset   = static_cast<uint32_t>(scene.meshes.size());
+        for (auto &record : result.records) {
+            record.firstVertex += (record.type == SceneRecordType::MESH ? meshOffset : vertexOffset);
+            scene.records.push_back(record);
+        }
+        scene.vertices.insert(scene.vertices.end(), result.vertices.begin(), result.vertices.end());
+        scene.meshes.insert(scene.meshes.end(), result.meshes.begin(), result.meshes.end());
+        scene.skippedLines += result.skippedLines;
+    }
+
+    if (scene.skippedLines) {
+        std::cerr << "ParseSceneText : skipped " << scene.skippedLines << " malformed lines\n";
+    }
+}
+
+bool ParseSceneFile(const std::string &path, ParsedScene &scene, size_t threadCount) {
+    std::ifstream file(path, std::ios::in | std::ios::binary | std::ios::ate);
+    if (!file) return false;
+
+    std::vector<char> text(static_cast<size_t>(file.tellg()));
+    file.seekg(0);
+    if (!file.read(text.data(), static_cast<std::streamsize>(text.size()))) return false;
+
+    ParseSceneText(std::move(text), scene, threadCount);
+    return true;
+}
+
+bool ParseSceneFileInParts(const std::string &path, const std::function<void(ParsedScene &&part, float progress)> &onPart,
+                           std::stop_token stop, size_t partSize)
+{
+    std::ifstream file(path, std::ios::in | std::ios::binary | std::ios::ate);
+    if (!file) return false;
+
+    size_t fileSize = static_cast<size_t>(file.tellg());
+    file.seekg(0);
+
+    std::vector<char> carry; // the unfinished last line of the previous read
+    size_t read = 0;
+    while (read < fileSize && !stop.stop_requested()) {
+        std::vector<char> text = std::move(carry);
+        size_t kept = text.size();
+        size_t size = std::min(partSize, fileSize - read);
+        text.resize(kept + size);
+        if (!file.read(text.data() + kept, static_cast<std::streamsize>(size))) return false;
+        read += size;
+
+        carry.clear();
+        if (read < fileSize) {
+            size_t cut = static_cast<size_t>(std::find(text.rbegin(), text.rend(), '\n').base() - text.begin());
+            carry.assign(text.begin() + cut, text.end());
+            text.resize(cut);
+        }
+        if (text.empty()) continue;
+
+        ParsedScene part;
+        ParseSceneText(std::move(text), part, 0, stop);
+        if (stop.stop_requested()) break;
+        onPart(std::move(part), static_cast<float>(read) / fileSize);
+    }
+    return true;
+}
+
+} // namespace roa
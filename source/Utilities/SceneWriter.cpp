@@ -0,0 +1,187 @@
+#include <algorithm>
+#include <charconv>
+#include <filesystem>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "Utilities/BinaryScene.hpp"
+#include "Utilities/SceneWriter.hpp"
+
+namespace roa
+{
+
+namespace
+{
+
+class TextAppender {
+    std::vector<char> &out;
+
+public:
+    explicit TextAppender(std::vector<char> &out_): out(out_) {}
+
+    TextAppender &operator<<(std::string_view str) {
+        out.insert(out.end(), str.begin(), str.end());
+        return *this;
+    }
+
+    TextAppender &operator<<(char c) {
+        out.push_back(c);
+        return *this;
+    }
+
+    template <typename T>
+    TextAppender &Number(T value) {
+        char buffer[32];
+        auto [ptr, ec] = std::to_chars(buffer, buffer + sizeof(buffer), value);
+        out.insert(out.end(), buffer, ptr);
+        return *this;
+    }
+
+    TextAppender &Numbers(const float *values, size_t count) {
+        for (size_t i = 0; i < count; i++) {
+            *this << ' ';
+            Number(values[i]);
+        }
+        return *this;
+    }
+};
+
+constexpr std::string_view recordName(SceneRecordType type) {
+    switch (type) {
+        case SceneRecordType::SPHERE:  return "Sphere";
+        case SceneRecordType::PLANE:   return "Plane";
+        case SceneRecordType::CUBE:    return "Cube";
+        case SceneRecordType::POLYGON: return "Polygon";
+        case SceneRecordType::MESH:    return "Mesh";
+        case SceneRecordType::LIGHT:   return "Light";
+    }
+    return "";
+}
+
+bool writeBuffer(const std::string &path, std::span<const char> data) {
+    int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) return false;
+
+    bool ok = WriteAll(fd, data) && (::fsync(fd) == 0);
+    return (::close(fd) == 0) && ok;
+}
+
+// makes a rename inside `dir` durable
+void syncDirectory(const std::filesystem::path &dir) {
+    int fd = ::open(dir.empty() ? "." : dir.c_str(), O_RDONLY | O_DIRECTORY);
+    if (fd < 0) return;
+    ::fsync(fd);
+    ::close(fd);
+}
+
+} // namespace
+
+bool WriteAll(int fd, std::span<const char> data) {
+    while (!data.empty()) {
+        ssize_t written = ::write(fd, data.data(), data.size());
+        if (written <= 0) return false;
+        data = data.subspan(static_cast<size_t>(written));
+    }
+    return true;
+}
+
+void FormatSceneRecord(const ParsedScene &scene, const SceneRecord &record, std::vector<char> &out) {
+    TextAppender text(out);
+    text << recordName(record.type);
+
+    if (record.type == SceneRecordType::LIGHT) {
+        text << ' ' << record.record;
+        return;
+    }
+
+    if (record.type == SceneRecordType::MESH) {
+        const SceneMesh &mesh = scene.meshes[record.firstVertex];
+        text.Numbers(mesh.toWorld, 12) << ' ';
+        text.Number(mesh.path.size());
+        text << ' ' << mesh.path;
+    } else {
+        text.Numbers(record.position, 3) << " 0";
+    }
+
+    switch (record.type) {
+        case SceneRecordType::SPHERE:
+            text.Numbers(record.params, 1);
+            break;
+        case SceneRecordType::PLANE:
+        case SceneRecordType::CUBE:
+            text.Numbers(record.params, 3);
+            break;
+        case SceneRecordType::POLYGON:
+            text << ' ';
+            text.Number(record.vertexCount);
+            for (uint32_t i = 0; i < record.vertexCount; i++) {
+                text.Numbers(scene.vertices[record.firstVertex + i].position, 3);
+            }
+            break;
+        case SceneRecordType::MESH:
+        case SceneRecordType::LIGHT:
+            break;
+    }
+
+    text << ' ';
+    if (record.material != NO_SCENE_MATERIAL) FormatSceneMaterial(scene.materials[record.material], out);
+    else text << record.record;
+    if (record.visibility != RAY_VISIBILITY_ALL) {
+        text << " Visibility ";
+        text.Number(static_cast<int>(record.visibility));
+    }
+    if (record.group != NO_SCENE_GROUP) {
+        text << " Group ";
+        text.Number(record.group);
+    }
+}
+
+void FormatSceneMaterial(const BinaryMaterial &material, std::vector<char> &out) {
+    TextAppender text(out);
+    text << material.GetType();
+    text.Numbers(material.params, std::min<size_t>(material.paramCount, BINARY_MATERIAL_MAX_PARAMS));
+}
+
+void FormatSceneText(const ParsedScene &scene, std::vector<char> &out) {
+    // a line is the numbers plus its record, ~96 bytes covers the numbers of a typical primitive
+    out.reserve(out.size() + scene.records.size() * 96 + scene.text.size());
+
+    for (const auto &record : scene.records) {
+        FormatSceneRecord(scene, record, out);
+        out.push_back('\n');
+    }
+}
+
+bool WriteFileAtomically(const std::string &path, const std::function<bool(const std::string &tmpPath)> &write) {
+    std::string tmpPath = path + ".tmp";
+    std::error_code ec;
+
+    if (!write(tmpPath)) {
+        std::filesystem::remove(tmpPath, ec);
+        return false;
+    }
+
+    std::filesystem::rename(tmpPath, path, ec);
+    if (!ec) {
+        syncDirectory(std::filesystem::path(path).parent_path());
+        return true;
+    }
+
+    std::filesystem::remove(tmpPath, ec);
+    return false;
+}
+
+bool WriteSceneFile(const std::string &path, const ParsedScene &scene) {
+    if (IsBinaryScenePath(path)) {
+        BinarySceneData data;
+        if (!BuildBinarySceneData(scene, data)) return false;
+        return WriteFileAtomically(path, [&data](const std::string &tmpPath) { return WriteBinaryScene(tmpPath, data); });
+    }
+
+    std::vector<char> text;
+    FormatSceneText(scene, text);
+    return WriteFileAtomically(path, [&text](const std::string &tmpPath) { return writeBuffer(tmpPath, text); });
+}
+
+} // namespace roa
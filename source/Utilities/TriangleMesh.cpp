@@ -0,0 +1,264 @@
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <utility>
+
+#include "Utilities/TriangleMesh.hpp"
+
+namespace roa
+{
+
+namespace
+{
+
+constexpr float INF = std::numeric_limits<float>::max();
+
+struct Box {
+    float min[3] = {INF, INF, INF};
+    float max[3] = {-INF, -INF, -INF};
+
+    void Grow(const float *p) {
+        for (int axis = 0; axis < 3; axis++) {
+            min[axis] = std::min(min[axis], p[axis]);
+            max[axis] = std::max(max[axis], p[axis]);
+        }
+    }
+
+    void Grow(const Box &other) {
+        for (int axis = 0; axis < 3; axis++) {
+            min[axis] = std::min(min[axis], other.min[axis]);
+            max[axis] = std::max(max[axis], other.max[axis]);
+        }
+    }
+
+    float HalfArea() const {
+        float dx = max[0] - min[0], dy = max[1] - min[1], dz = max[2] - min[2];
+        return (dx < 0 ? 0 : dx * dy + dy * dz + dz * dx);
+    }
+};
+
+struct Bin {
+    Box      box;
+    uint32_t count = 0;
+};
+
+// slab test, returns the entry distance or INF on miss
+float intersectBox(const TriangleMesh::BVHNode &node, const float (&origin)[3], const float (&invDirection)[3], float tMax) {
+    float tNear = 0, tFar = tMax;
+    for (int axis = 0; axis < 3; axis++) {
+        float t0 = (node.min[axis] - origin[axis]) * invDirection[axis];
+        float t1 = (node.max[axis] - origin[axis]) * invDirection[axis];
+        if (t0 > t1) std::swap(t0, t1);
+        tNear = std::max(tNear, t0);
+        tFar  = std::min(tFar, t1);
+    }
+    return (tNear <= tFar ? tNear : INF);
+}
+
+// Moller-Trumbore, returns t or a negative value on miss
+float intersectTriangle(const float (&o)[3], const float (&d)[3], const float *a, const float *b, const float *c) {
+    float e1[3] = {b[0] - a[0], b[1] - a[1], b[2] - a[2]};
+    float e2[3] = {c[0] - a[0], c[1] - a[1], c[2] - a[2]};
+    float p[3]  = {d[1] * e2[2] - d[2] * e2[1], d[2] * e2[0] - d[0] * e2[2], d[0] * e2[1] - d[1] * e2[0]};
+
+    float det = e1[0] * p[0] + e1[1] * p[1] + e1[2] * p[2];
+    if (std::fabs(det) < 1e-12f) return -1;
+    float inv = 1 / det;
+
+    float s[3] = {o[0] - a[0], o[1] - a[1], o[2] - a[2]};
+    float u = (s[0] * p[0] + s[1] * p[1] + s[2] * p[2]) * inv;
+    if (u < 0 || u > 1) return -1;
+
+    float q[3] = {s[1] * e1[2] - s[2] * e1[1], s[2] * e1[0] - s[0] * e1[2], s[0] * e1[1] - s[1] * e1[0]};
+    float v = (d[0] * q[0] + d[1] * q[1] + d[2] * q[2]) * inv;
+    if (v < 0 || u + v > 1) return -1;
+
+    return (e2[0] * q[0] + e2[1] * q[1] + e2[2] * q[2]) * inv;
+}
+
+} // namespace
+
+TriangleMesh::TriangleMesh(std::vector<MeshVertex> vertices_, std::vector<uint32_t> indices_):
+    vertices(std::move(vertices_)),
+    indices(std::move(indices_))
+{
+    indices.resize(indices.size() / 3 * 3);
+
+    size_t kept = 0;
+    for (size_t i = 0; i < indices.size(); i += 3) {
+        if (indices[i] >= vertices.size() || indices[i + 1] >= vertices.size() || indices[i + 2] >= vertices.size()) continue;
+        std::copy_n(indices.begin() + i, 3, indices.begin() + kept);
+        kept += 3;
+    }
+    indices.resize(kept);
+
+    buildBVH();
+}
+
+MeshBounds TriangleMesh::GetBounds() const {
+    if (nodes.empty()) return {};
+    return {{nodes[0].min[0], nodes[0].min[1], nodes[0].min[2]}, {nodes[0].max[0], nodes[0].max[1], nodes[0].max[2]}};
+}
+
+// Binned SAH over triangle centroids; falls back to a median split when
+// all centroids land in one bin.
+void TriangleMesh::buildBVH() {
+    nodes.clear();
+    uint32_t triangleCount = static_cast<uint32_t>(GetTriangleCount());
+    if (triangleCount == 0) return;
+
+    std::vector<Box>      boxes(triangleCount);
+    std::vector<float>    centroids(static_cast<size_t>(triangleCount) * 3);
+    std::vector<uint32_t> order(triangleCount);
+    for (uint32_t t = 0; t < triangleCount; t++) {
+        for (int corner = 0; corner < 3; corner++) boxes[t].Grow(vertices[indices[t * 3 + corner]].position);
+        for (int axis = 0; axis < 3; axis++) centroids[t * 3 + axis] = (boxes[t].min[axis] + boxes[t].max[axis]) / 2;
+        order[t] = t;
+    }
+
+    nodes.reserve(static_cast<size_t>(triangleCount) * 2);
+    nodes.push_back({{0, 0, 0}, 0, {0, 0, 0}, triangleCount});
+
+    std::vector<std::pair<uint32_t, int>> stack = {{0, 0}}; // node, depth
+    while (!stack.empty()) {
+        auto [nodeIndex, depth] = stack.back();
+        stack.pop_back();
+        uint32_t first = nodes[nodeIndex].first, count = nodes[nodeIndex].count;
+
+        Box box, centroidBox;
+        for (uint32_t i = first; i < first + count; i++) {
+            box.Grow(boxes[order[i]]);
+            centroidBox.Grow(&centroids[order[i] * 3]);
+        }
+        std::copy_n(box.min, 3, nodes[nodeIndex].min);
+        std::copy_n(box.max, 3, nodes[nodeIndex].max);
+        if (count <= MAX_LEAF_TRIANGLES) continue;
+
+        // pick the cheapest bin boundary over all three axes
+        float    bestCost = static_cast<float>(count) * box.HalfArea();
+        int      bestAxis = -1;
+        int      bestSplit = 0;
+        // deep nodes only take median splits, which bounds the depth for the traversal stack
+        for (int axis = 0; axis < 3 && depth < MEDIAN_SPLIT_DEPTH; axis++) {
+            float extent = centroidBox.max[axis] - centroidBox.min[axis];
+            if (extent <= 0) continue;
+
+            Bin bins[SAH_BINS];
+            float scale = SAH_BINS / extent;
+            for (uint32_t i = first; i < first + count; i++) {
+                int bin = std::min(SAH_BINS - 1, static_cast<int>((centroids[order[i] * 3 + axis] - centroidBox.min[axis]) * scale));
+                bins[bin].count++;
+                bins[bin].box.Grow(boxes[order[i]]);
+            }
+
+            float    rightArea[SAH_BINS - 1];
+            uint32_t rightCount[SAH_BINS - 1];
+            Box      right;
+            uint32_t rightSum = 0;
+            for (int i = SAH_BINS - 1; i > 0; i--) {
+                right.Grow(bins[i].box);
+                rightSum += bins[i].count;
+                rightArea[i - 1]  = right.HalfArea();
+                rightCount[i - 1] = rightSum;
+            }
+
+            Box      left;
+            uint32_t leftSum = 0;
+            for (int i = 0; i < SAH_BINS - 1; i++) {
+                left.Grow(bins[i].box);
+                leftSum += bins[i].count;
+                if (leftSum == 0 || rightCount[i] == 0) continue;
+                float cost = leftSum * left.HalfArea() + rightCount[i] * rightArea[i];
+                if (cost < bestCost) {
+                    bestCost  = cost;
+                    bestAxis  = axis;
+                    bestSplit = i;
+                }
+            }
+        }
+
+        uint32_t *begin = order.data() + first;
+        uint32_t *end   = begin + count;
+        uint32_t *middle = nullptr;
+        if (bestAxis >= 0) {
+            float scale = SAH_BINS / (centroidBox.max[bestAxis] - centroidBox.min[bestAxis]);
+            middle = std::partition(begin, end, [&](uint32_t t) {
+                int bin = std::min(SAH_BINS - 1, static_cast<int>((centroids[t * 3 + bestAxis] - centroidBox.min[bestAxis]) * scale));
+                return bin <= bestSplit;
+            });
+        } else {
+            // no split beats a leaf; large nodes are still halved so leaves stay small
+            if (count <= MAX_LEAF_TRIANGLES * 4 && depth < MEDIAN_SPLIT_DEPTH) continue;
+            int axis = 0;
+            for (int a = 1; a < 3; a++) {
+                if (box.max[a] - box.min[a] > box.max[axis] - box.min[axis]) axis = a;
+            }
+            middle = begin + count / 2;
+            std::nth_element(begin, middle, end, [&](uint32_t l, uint32_t r) {
+                return centroids[l * 3 + axis] < centroids[r * 3 + axis];
+            });
+        }
+
+        uint32_t leftCount = static_cast<uint32_t>(middle - begin);
+        uint32_t children  = static_cast<uint32_t>(nodes.size());
+        nodes.push_back({{0, 0, 0}, first, {0, 0, 0}, leftCount});
+        nodes.push_back({{0, 0, 0}, first + leftCount, {0, 0, 0}, count - leftCount});
+        nodes[nodeIndex].first = children;
+        nodes[nodeIndex].count = 0;
+
+        stack.push_back({children, depth + 1});
+        stack.push_back({children + 1, depth + 1});
+    }
+
+    std::vector<uint32_t> ordered(indices.size());
+    for (uint32_t i = 0; i < triangleCount; i++) {
+        std::copy_n(indices.begin() + order[i] * 3, 3, ordered.begin() + i * 3);
+    }
+    indices = std::move(ordered);
+    nodes.shrink_to_fit();
+}
+
+std::optional<TriangleMesh::Hit> TriangleMesh::Intersect(const float (&origin)[3], const float (&direction)[3], float tMax) const {
+    if (nodes.empty()) return std::nullopt;
+
+    float invDirection[3];
+    for (int axis = 0; axis < 3; axis++) invDirection[axis] = 1 / direction[axis];
+
+    std::optional<Hit> best;
+    uint32_t stack[MAX_DEPTH + 1];
+    int      stackSize = 0;
+    if (intersectBox(nodes[0], origin, invDirection, tMax) == INF) return std::nullopt;
+    stack[stackSize++] = 0;
+
+    while (stackSize > 0) {
+        const BVHNode &node = nodes[stack[--stackSize]];
+
+        if (node.count > 0) {
+            for (uint32_t t = node.first; t < node.first + node.count; t++) {
+                const float *a = vertices[indices[t * 3    ]].position;
+                const float *b = vertices[indices[t * 3 + 1]].position;
+                const float *c = vertices[indices[t * 3 + 2]].position;
+                float hit = intersectTriangle(origin, direction, a, b, c);
+                if (hit > 0 && hit < tMax) {
+                    tMax = hit;
+                    best = Hit{hit, t};
+                }
+            }
+            continue;
+        }
+
+        // nearer child goes on top of the stack
+        float tLeft  = intersectBox(nodes[node.first],     origin, invDirection, tMax);
+        float tRight = intersectBox(nodes[node.first + 1], origin, invDirection, tMax);
+        uint32_t nearChild = node.first, farChild = node.first + 1;
+        if (tRight < tLeft) {
+            std::swap(tLeft, tRight);
+            std::swap(nearChild, farChild);
+        }
+        if (tRight != INF) stack[stackSize++] = farChild;
+        if (tLeft  != INF) stack[stackSize++] = nearChild;
+    }
+    return best;
+}
+
+} // namespace roa